@@ -0,0 +1,124 @@
+#include "CoroRuntime.hpp"
+#include "ThreadUtils.hpp"
+#include <thread>
+#include <algorithm>
+
+static thread_local CoroRuntime *tls_runtime = nullptr;
+
+// -------------------- Job --------------------
+Job::Job(std::coroutine_handle<promise_type> h)
+    : handle(h)
+    {}
+
+Job::Job(Job &&other) noexcept
+    : handle(other.handle)
+{
+    other.handle = nullptr;
+}
+
+Job::~Job(){
+    // only a job that never started still owns its frame
+    if (handle) handle.destroy();
+}
+
+void Job::run_inline(){
+    auto h = handle;
+    handle = nullptr;
+    h.resume();
+}
+
+void Job::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+    CoroRuntime *rt = h.promise().runtime;
+    h.destroy();
+    if (rt) rt->job_done();
+}
+
+// -------------------- CoroRuntime --------------------
+CoroRuntime::CoroRuntime(int num_workers)
+    : live_jobs(0), num_workers(std::max(1, num_workers)),
+      epoch(std::chrono::steady_clock::now())
+    {}
+
+void CoroRuntime::spawn(Job &&job){
+    auto h = job.handle;
+    job.handle = nullptr;
+    h.promise().runtime = this;
+    live_jobs += 1;
+    schedule(h);
+}
+
+void CoroRuntime::run(){
+    std::vector<std::thread> workers;
+    for (int i = 1; i < num_workers; ++i)
+        workers.emplace_back(&CoroRuntime::worker_loop, this);
+    worker_loop();
+    for (auto &w : workers) w.join();
+}
+
+CoroRuntime *CoroRuntime::current(){
+    return tls_runtime;
+}
+
+void CoroRuntime::schedule(std::coroutine_handle<> h){
+    lock.lock();
+    ready.push_back(h);
+    lock.unlock();
+}
+
+void CoroRuntime::schedule_after(std::coroutine_handle<> h, TimerNode *node, int duration_us){
+    node->data = h.address();
+    lock.lock();
+    timers.insert(node, now_us() + duration_us);
+    lock.unlock();
+}
+
+void CoroRuntime::job_done(){
+    live_jobs -= 1;
+}
+
+uint64_t CoroRuntime::now_us() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+void CoroRuntime::worker_loop(){
+    tls_runtime = this;
+    while (live_jobs.load() > 0){
+        std::coroutine_handle<> h;
+        lock.lock();
+        timers.advance(now_us(), expired);
+        for (TimerNode *node : expired)
+            ready.push_back(std::coroutine_handle<>::from_address(node->data));
+        expired.clear();
+        if (!ready.empty()){
+            h = ready.front();
+            ready.pop_front();
+        }
+        lock.unlock();
+
+        if (h) h.resume();
+        else std::this_thread::yield();
+    }
+    tls_runtime = nullptr;
+}
+
+// -------------------- awaitables --------------------
+bool sleep_for::await_ready(){
+    if (CoroRuntime::current() == nullptr){
+        busy_sleep_microseconds(duration_us);
+        return true;
+    }
+    return duration_us <= 0;
+}
+
+void sleep_for::await_suspend(std::coroutine_handle<> h){
+    CoroRuntime::current()->schedule_after(h, &node, duration_us);
+}
+
+bool yield_now::await_ready(){
+    return CoroRuntime::current() == nullptr;
+}
+
+void yield_now::await_suspend(std::coroutine_handle<> h){
+    CoroRuntime::current()->schedule(h);
+}
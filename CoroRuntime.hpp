@@ -0,0 +1,104 @@
+#ifndef CORO_RUNTIME_HPP
+#define CORO_RUNTIME_HPP
+
+#include <coroutine>
+#include <exception>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "TimerWheel.hpp"
+
+// M:N execution of emulated CPUs and IO devices.
+//
+// processor() and IO_device() are written once as coroutines returning Job.
+// In thread mode each Job runs inline on its own pthread and the awaitables
+// below never suspend (sleep_for busy-waits, yield_now is a no-op), which is
+// exactly the original behaviour. In coroutine mode a CoroRuntime multiplexes
+// all Jobs over a few worker threads and wakes sleepers from a TimerWheel.
+
+class CoroRuntime;
+
+class Job {
+public:
+    struct promise_type {
+        CoroRuntime *runtime = nullptr;
+
+        Job get_return_object(){
+            return Job(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        // the frame frees itself, so nobody has to observe done() after a resume
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            void await_suspend(std::coroutine_handle<promise_type> h) noexcept;
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    Job(Job &&other) noexcept;
+    Job(const Job&) = delete;
+    Job &operator=(const Job&) = delete;
+    ~Job();
+
+    // thread mode: run to completion on the calling thread
+    void run_inline();
+
+private:
+    friend class CoroRuntime;
+    explicit Job(std::coroutine_handle<promise_type> h);
+    std::coroutine_handle<promise_type> handle;
+};
+
+class CoroRuntime {
+    std::mutex lock;          // ready and timers
+    std::deque<std::coroutine_handle<>> ready;
+    TimerWheel timers;
+    std::vector<TimerNode*> expired;
+    std::atomic<int> live_jobs;
+    int num_workers;
+    std::chrono::steady_clock::time_point epoch;
+
+public:
+    explicit CoroRuntime(int num_workers);
+    // takes ownership of the job, it starts once run() is called
+    void spawn(Job &&job);
+    // blocks until every spawned job has finished
+    void run();
+
+    // runtime driving the calling thread, nullptr in thread mode
+    static CoroRuntime *current();
+
+    void schedule(std::coroutine_handle<> h);
+    // node must stay alive until h is resumed, sleep_for keeps it in the frame
+    void schedule_after(std::coroutine_handle<> h, TimerNode *node, int duration_us);
+    void job_done();
+
+private:
+    void worker_loop();
+    uint64_t now_us() const;
+};
+
+// co_await sleep_for(us): burst of duration_us
+struct sleep_for {
+    int duration_us;
+    TimerNode node;
+    explicit sleep_for(int us) : duration_us(us) {}
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    void await_resume() {}
+};
+
+// co_await yield_now(): let other emulated devices run while polling
+struct yield_now {
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> h);
+    void await_resume() {}
+};
+
+#endif
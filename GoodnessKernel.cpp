@@ -0,0 +1,208 @@
+#include "GoodnessKernel.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define GOODNESS_X86 1
+#endif
+
+void ReadyQueueSoA::push_back(Task *task){
+    policy.push_back(task->policy);
+    rt_priority.push_back(task->rt_priority);
+    nice.push_back(task->nice);
+    device.push_back(task->bursts.front().first);
+    remaining.push_back(task->bursts.front().second);
+    affinity.push_back(task->cpu_affinity);
+    last_cpu.push_back(task->last_cpu);
+    tasks.push_back(task);
+}
+
+// keeps order: the scan is O(n) anyway and memmove is far cheaper than it
+void ReadyQueueSoA::erase(int idx){
+    policy.erase(policy.begin() + idx);
+    rt_priority.erase(rt_priority.begin() + idx);
+    nice.erase(nice.begin() + idx);
+    device.erase(device.begin() + idx);
+    remaining.erase(remaining.begin() + idx);
+    affinity.erase(affinity.begin() + idx);
+    last_cpu.erase(last_cpu.begin() + idx);
+    tasks.erase(tasks.begin() + idx);
+}
+
+int ReadyQueueSoA::size() const {
+    return tasks.size();
+}
+
+bool ReadyQueueSoA::empty() const {
+    return tasks.empty();
+}
+
+// finish [from, n) with the scalar rule, strict > keeps the earliest maximum
+static int scalar_tail(const ReadyQueueSoA &rq, int cpu_id, int from, int best_idx, int best_val){
+    int n = rq.size();
+    for (int i = from; i < n; ++i){
+        int g = goodness(cpu_id, rq.policy[i], rq.rt_priority[i], rq.nice[i],
+                         rq.device[i], rq.remaining[i], rq.affinity[i], rq.last_cpu[i]);
+        if (g > best_val){
+            best_val = g;
+            best_idx = i;
+        }
+    }
+    return best_idx;
+}
+
+int goodness_argmax_scalar(const ReadyQueueSoA &rq, int cpu_id){
+    return scalar_tail(rq, cpu_id, 0, -1, INT_MIN);
+}
+
+// lanes hold the per-lane maximum and the earliest index reaching it;
+// the overall answer is the smallest index among lanes with the global maximum
+static void reduce_lanes(const int *val, const int *idx, int lanes, int &best_val, int &best_idx){
+    for (int l = 0; l < lanes; ++l){
+        if (idx[l] < 0) continue;
+        if (val[l] > best_val || (val[l] == best_val && idx[l] < best_idx)){
+            best_val = val[l];
+            best_idx = idx[l];
+        }
+    }
+}
+
+#ifdef GOODNESS_X86
+
+int goodness_argmax_sse2(const ReadyQueueSoA &rq, int cpu_id){
+    int n = rq.size();
+    const __m128i vcpu = _mm_set1_epi32(cpu_id);
+    const __m128i v1000 = _mm_set1_epi32(1000);
+    const __m128i v20 = _mm_set1_epi32(20);
+    const __m128i vzero = _mm_setzero_si128();
+    const __m128i vnone = _mm_set1_epi32(-1);
+    const __m128i vwarm = _mm_set1_epi32(PROC_CHANGE_PENALTY);
+    const __m128i vmin = _mm_set1_epi32(INT_MIN);
+    const __m128i vstep = _mm_set1_epi32(4);
+    __m128i best = vmin;
+    __m128i best_idx = _mm_set1_epi32(-1);
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4){
+        __m128i pol = _mm_loadu_si128((const __m128i*)&rq.policy[i]);
+        __m128i rt = _mm_loadu_si128((const __m128i*)&rq.rt_priority[i]);
+        __m128i ni = _mm_loadu_si128((const __m128i*)&rq.nice[i]);
+        __m128i dev = _mm_loadu_si128((const __m128i*)&rq.device[i]);
+        __m128i rem = _mm_loadu_si128((const __m128i*)&rq.remaining[i]);
+        __m128i aff = _mm_loadu_si128((const __m128i*)&rq.affinity[i]);
+        __m128i last = _mm_loadu_si128((const __m128i*)&rq.last_cpu[i]);
+
+        // SCHED_OTHER: remaining + (last == cpu) * 15 + (device == cpu) + 20 - nice,
+        // cmpeq yields -1
+        __m128i other = _mm_add_epi32(rem, _mm_sub_epi32(v20, ni));
+        other = _mm_sub_epi32(other, _mm_cmpeq_epi32(dev, vcpu));
+        other = _mm_add_epi32(other, _mm_and_si128(_mm_cmpeq_epi32(last, vcpu), vwarm));
+        __m128i rtv = _mm_add_epi32(v1000, rt);
+        __m128i is_other = _mm_cmpeq_epi32(pol, vzero);
+        __m128i g = _mm_or_si128(_mm_and_si128(is_other, other), _mm_andnot_si128(is_other, rtv));
+        // pinned elsewhere: INT_MIN never beats the running maximum
+        __m128i allowed = _mm_or_si128(_mm_cmpeq_epi32(aff, vnone), _mm_cmpeq_epi32(aff, vcpu));
+        g = _mm_or_si128(_mm_and_si128(allowed, g), _mm_andnot_si128(allowed, vmin));
+
+        __m128i gt = _mm_cmpgt_epi32(g, best);
+        best = _mm_or_si128(_mm_and_si128(gt, g), _mm_andnot_si128(gt, best));
+        best_idx = _mm_or_si128(_mm_and_si128(gt, idx), _mm_andnot_si128(gt, best_idx));
+        idx = _mm_add_epi32(idx, vstep);
+    }
+
+    alignas(16) int lane_val[4], lane_idx[4];
+    _mm_store_si128((__m128i*)lane_val, best);
+    _mm_store_si128((__m128i*)lane_idx, best_idx);
+    int best_val = INT_MIN, best_i = -1;
+    reduce_lanes(lane_val, lane_idx, 4, best_val, best_i);
+    return scalar_tail(rq, cpu_id, i, best_i, best_val);
+}
+
+__attribute__((target("avx2")))
+int goodness_argmax_avx2(const ReadyQueueSoA &rq, int cpu_id){
+    int n = rq.size();
+    const __m256i vcpu = _mm256_set1_epi32(cpu_id);
+    const __m256i v1000 = _mm256_set1_epi32(1000);
+    const __m256i v20 = _mm256_set1_epi32(20);
+    const __m256i vzero = _mm256_setzero_si256();
+    const __m256i vnone = _mm256_set1_epi32(-1);
+    const __m256i vwarm = _mm256_set1_epi32(PROC_CHANGE_PENALTY);
+    const __m256i vmin = _mm256_set1_epi32(INT_MIN);
+    const __m256i vstep = _mm256_set1_epi32(8);
+    __m256i best = vmin;
+    __m256i best_idx = _mm256_set1_epi32(-1);
+    __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8){
+        __m256i pol = _mm256_loadu_si256((const __m256i*)&rq.policy[i]);
+        __m256i rt = _mm256_loadu_si256((const __m256i*)&rq.rt_priority[i]);
+        __m256i ni = _mm256_loadu_si256((const __m256i*)&rq.nice[i]);
+        __m256i dev = _mm256_loadu_si256((const __m256i*)&rq.device[i]);
+        __m256i rem = _mm256_loadu_si256((const __m256i*)&rq.remaining[i]);
+        __m256i aff = _mm256_loadu_si256((const __m256i*)&rq.affinity[i]);
+        __m256i last = _mm256_loadu_si256((const __m256i*)&rq.last_cpu[i]);
+
+        __m256i other = _mm256_add_epi32(rem, _mm256_sub_epi32(v20, ni));
+        other = _mm256_sub_epi32(other, _mm256_cmpeq_epi32(dev, vcpu));
+        other = _mm256_add_epi32(other, _mm256_and_si256(_mm256_cmpeq_epi32(last, vcpu), vwarm));
+        __m256i rtv = _mm256_add_epi32(v1000, rt);
+        __m256i is_other = _mm256_cmpeq_epi32(pol, vzero);
+        __m256i g = _mm256_blendv_epi8(rtv, other, is_other);
+        __m256i allowed = _mm256_or_si256(_mm256_cmpeq_epi32(aff, vnone), _mm256_cmpeq_epi32(aff, vcpu));
+        g = _mm256_blendv_epi8(vmin, g, allowed);
+
+        __m256i gt = _mm256_cmpgt_epi32(g, best);
+        best = _mm256_blendv_epi8(best, g, gt);
+        best_idx = _mm256_blendv_epi8(best_idx, idx, gt);
+        idx = _mm256_add_epi32(idx, vstep);
+    }
+
+    alignas(32) int lane_val[8], lane_idx[8];
+    _mm256_store_si256((__m256i*)lane_val, best);
+    _mm256_store_si256((__m256i*)lane_idx, best_idx);
+    int best_val = INT_MIN, best_i = -1;
+    reduce_lanes(lane_val, lane_idx, 8, best_val, best_i);
+    return scalar_tail(rq, cpu_id, i, best_i, best_val);
+}
+
+#else
+
+int goodness_argmax_sse2(const ReadyQueueSoA &rq, int cpu_id){
+    return goodness_argmax_scalar(rq, cpu_id);
+}
+
+int goodness_argmax_avx2(const ReadyQueueSoA &rq, int cpu_id){
+    return goodness_argmax_scalar(rq, cpu_id);
+}
+
+#endif
+
+typedef int (*argmax_fn)(const ReadyQueueSoA&, int);
+
+static argmax_fn pick_kernel(const char **name){
+#ifdef GOODNESS_X86
+    // runs during static initialization, before libgcc may have probed the cpu
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        *name = "avx2";
+        return goodness_argmax_avx2;
+    }
+    *name = "sse2";
+    return goodness_argmax_sse2;
+#else
+    *name = "scalar";
+    return goodness_argmax_scalar;
+#endif
+}
+
+static const char *kernel_name = nullptr;
+static const argmax_fn kernel = pick_kernel(&kernel_name);
+
+int goodness_argmax(const ReadyQueueSoA &rq, int cpu_id){
+    return kernel(rq, cpu_id);
+}
+
+const char *goodness_kernel_name(){
+    return kernel_name;
+}
@@ -0,0 +1,62 @@
+#ifndef GOODNESS_KERNEL_HPP
+#define GOODNESS_KERNEL_HPP
+
+#include "Task.hpp"
+#include <vector>
+#include <climits>
+
+// bonus for staying on the cpu that ran the previous burst, linux 2.4 x86 value
+const int PROC_CHANGE_PENALTY = 15;
+
+// linux 2.4 style goodness used by Scheduler_On
+inline int goodness(int cpu_id, int policy, int rt_priority, int nice, int device, int remaining,
+                    int affinity, int last_cpu){
+    if (affinity >= 0 && affinity != cpu_id){
+        // pinned to another cpu, never picked here
+        return INT_MIN;
+    }
+    if (policy){ // policy == 1 || == 2
+        // low priority tasks (high priority value) runs first
+        return 1000 + rt_priority;
+    }
+    int weight = remaining;
+    if (last_cpu == cpu_id){
+        weight += PROC_CHANGE_PENALTY;
+    }
+    if (device == cpu_id){
+        weight += 1;
+    }
+    weight += 20 - nice;
+    return weight;
+}
+
+// structure-of-arrays ready queue: the fields goodness needs are stored
+// contiguously so the O(n) scan never touches Task or its bursts.
+// entries stay in insertion order, so "first maximum" matches the old list scan.
+struct ReadyQueueSoA {
+    std::vector<int> policy;
+    std::vector<int> rt_priority;
+    std::vector<int> nice;
+    std::vector<int> device;      // device id of the next burst
+    std::vector<int> remaining;   // duration of the next burst
+    std::vector<int> affinity;    // hard affinity, -1 if none
+    std::vector<int> last_cpu;
+    std::vector<Task*> tasks;
+
+    void push_back(Task *task);
+    void erase(int idx);
+    int size() const;
+    bool empty() const;
+};
+
+// index of the first entry with the highest goodness, -1 if rq is empty
+// or every task in it is pinned to another cpu
+int goodness_argmax(const ReadyQueueSoA &rq, int cpu_id);
+
+// individual kernels, exposed for benchmarking
+int goodness_argmax_scalar(const ReadyQueueSoA &rq, int cpu_id);
+int goodness_argmax_sse2(const ReadyQueueSoA &rq, int cpu_id);
+int goodness_argmax_avx2(const ReadyQueueSoA &rq, int cpu_id);
+const char *goodness_kernel_name();
+
+#endif
@@ -2,19 +2,45 @@
 
 
 Logger::Logger(const std::string& filename,
-               std::chrono::steady_clock::time_point t0)
-            : file(filename, std::ios::out | std::ios::trunc), start_time(t0) {}
+               std::chrono::steady_clock::time_point t0, bool enabled)
+            : start_time(t0), enabled(enabled), metrics(nullptr) {
+    if (enabled) file.open(filename, std::ios::out | std::ios::trunc);
+}
 
-void Logger::write(const std::string& thread_type, int thread_id,
-                   int task_id, const std::string& event,
-                   const std::string& extra) {
-            
+void Logger::set_metrics(MetricsAccumulator *acc){
+    metrics = acc;
+}
+
+long long Logger::now_us() const {
     using namespace std::chrono;
     auto now = steady_clock::now();
-    auto us = duration_cast<microseconds>(now - start_time).count();
+    return duration_cast<microseconds>(now - start_time).count();
+}
+
+void Logger::write_line(long long us, const std::string& thread_type, int thread_id,
+                        int task_id, const std::string& event, const std::string& extra){
     file << us << " " << thread_type << " " << thread_id
             << " " << task_id << " " << event;
     if (!extra.empty()) file << " " << extra;
     file << "\n";
 }
 
+void Logger::write(const std::string& thread_type, int thread_id,
+                   int task_id, const std::string& event,
+                   const std::string& extra) {
+    if (!enabled) return;
+    write_line(now_us(), thread_type, thread_id, task_id, event, extra);
+}
+
+void Logger::write(const std::string& thread_type, int thread_id,
+                   Task *task, const std::string& event,
+                   const std::string& extra) {
+    if (!enabled && !metrics) return;
+    long long us = now_us();
+    if (metrics){
+        if (event == "ENTER_SCHED") metrics->enter_sched(task, us);
+        else if (event == "ENTER_CPU") metrics->enter_cpu(task, us);
+        else if (event == "FINISH_CPU" || event == "FINISH_IO") metrics->finish(task, us);
+    }
+    if (enabled) write_line(us, thread_type, thread_id, task->task_id, event, extra);
+}
@@ -2,17 +2,33 @@
 #include <fstream>
 #include <chrono>
 #include <string>
+#include "Task.hpp"
+#include "Metrics.hpp"
 
 class Logger {
     std::ofstream file;
     std::chrono::steady_clock::time_point start_time;
+    bool enabled;
+    MetricsAccumulator *metrics;
 
 public:
+    // enabled = false: no file is created, only metrics are recorded
     Logger(const std::string& filename,
-           std::chrono::steady_clock::time_point t0);
+           std::chrono::steady_clock::time_point t0, bool enabled = true);
 //        : file(filename, std::ios::out | std::ios::trunc), start_time(t0) {}
 
+    void set_metrics(MetricsAccumulator *acc);
+
     void write(const std::string& thread_type, int thread_id,
                int task_id, const std::string& event,
                const std::string& extra = "");
+    // same line, and ENTER_SCHED/ENTER_CPU/FINISH_* also update the metrics
+    void write(const std::string& thread_type, int thread_id,
+               Task *task, const std::string& event,
+               const std::string& extra = "");
+
+private:
+    long long now_us() const;
+    void write_line(long long us, const std::string& thread_type, int thread_id,
+                    int task_id, const std::string& event, const std::string& extra);
 };
@@ -0,0 +1,122 @@
+#include "Metrics.hpp"
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+
+MetricsAccumulator::MetricsAccumulator()
+    : resumed_bursts(0), warm_bursts(0)
+    {}
+
+void MetricsAccumulator::enter_sched(Task *task, long long now_us){
+    if (task->first_sched < 0) task->first_sched = now_us;
+    task->last_sched = now_us;
+}
+
+void MetricsAccumulator::enter_cpu(Task *task, long long now_us){
+    if (task->first_cpu < 0) task->first_cpu = now_us;
+    if (task->last_sched >= 0) task->waiting += now_us - task->last_sched;
+}
+
+void MetricsAccumulator::finish(Task *task, long long now_us){
+    // metrics.py skips tasks that never reached a cpu, so do we
+    if (task->first_sched < 0 || task->first_cpu < 0) return;
+    TaskRecord r;
+    r.task_id = task->task_id;
+    r.arrival = task->first_sched;
+    r.waiting = task->waiting;
+    r.turnaround = now_us - task->first_sched;
+    r.response = task->first_cpu - task->first_sched;
+    records.push_back(r);
+}
+
+void MetricsAccumulator::cpu_burst(const Task *task, int cpu_id){
+    if (task->last_cpu < 0) return;
+    resumed_bursts += 1;
+    if (task->last_cpu == cpu_id) warm_bursts += 1;
+}
+
+const std::vector<TaskRecord> &MetricsAccumulator::get_records() const {
+    return records;
+}
+
+long long MetricsAccumulator::get_resumed_bursts() const {
+    return resumed_bursts;
+}
+
+long long MetricsAccumulator::get_warm_bursts() const {
+    return warm_bursts;
+}
+
+MetricsSummary::MetricsSummary()
+    : num_tasks(0), avg_waiting(0), avg_turnaround(0), avg_response(0),
+      waiting_pct{0, 0, 0}, turnaround_pct{0, 0, 0}, response_pct{0, 0, 0},
+      makespan(0), throughput(0), resumed_bursts(0), warm_bursts(0), cache_warmth(0),
+      deadline_admitted(0), deadline_rejected(0), deadline_missed(0)
+    {}
+
+std::string MetricsSummary::to_string() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2)
+        << "Metrics over " << num_tasks << " tasks (avg / p50 / p95 / p99 us)\n"
+        << "  waiting:    " << avg_waiting << " / " << waiting_pct[0] << " / "
+        << waiting_pct[1] << " / " << waiting_pct[2] << "\n"
+        << "  turnaround: " << avg_turnaround << " / " << turnaround_pct[0] << " / "
+        << turnaround_pct[1] << " / " << turnaround_pct[2] << "\n"
+        << "  response:   " << avg_response << " / " << response_pct[0] << " / "
+        << response_pct[1] << " / " << response_pct[2] << "\n"
+        << "  makespan: " << makespan << " us, throughput: " << throughput << " tasks/s\n"
+        << "  cache warmth: " << cache_warmth * 100 << "% (" << warm_bursts << " of "
+        << resumed_bursts << " bursts on the previous cpu)\n";
+    if (deadline_admitted + deadline_rejected > 0)
+        oss << "  deadlines: admitted " << deadline_admitted << ", rejected " << deadline_rejected
+            << ", missed " << deadline_missed << " (of admitted)\n";
+    return oss.str();
+}
+
+// nearest-rank percentiles of values, which gets sorted
+static void percentiles(std::vector<long long> &values, long long out[3]){
+    std::sort(values.begin(), values.end());
+    const double ps[3] = {0.50, 0.95, 0.99};
+    for (int i = 0; i < 3; ++i){
+        size_t rank = (size_t)(ps[i] * values.size());
+        out[i] = values[std::min(rank, values.size() - 1)];
+    }
+}
+
+MetricsSummary merge_metrics(const MetricsAccumulator *acc, int n){
+    MetricsSummary s;
+    std::vector<long long> waiting, turnaround, response;
+    long long first_arrival = -1, last_finish = -1;
+    for (int i = 0; i < n; ++i){
+        s.resumed_bursts += acc[i].get_resumed_bursts();
+        s.warm_bursts += acc[i].get_warm_bursts();
+        for (const TaskRecord &r : acc[i].get_records()){
+            waiting.push_back(r.waiting);
+            turnaround.push_back(r.turnaround);
+            response.push_back(r.response);
+            if (first_arrival < 0 || r.arrival < first_arrival) first_arrival = r.arrival;
+            last_finish = std::max(last_finish, r.arrival + r.turnaround);
+        }
+    }
+    if (s.resumed_bursts > 0)
+        s.cache_warmth = (double)s.warm_bursts / s.resumed_bursts;
+    s.num_tasks = waiting.size();
+    if (s.num_tasks == 0) return s;
+
+    long long sum_w = 0, sum_t = 0, sum_r = 0;
+    for (int i = 0; i < s.num_tasks; ++i){
+        sum_w += waiting[i];
+        sum_t += turnaround[i];
+        sum_r += response[i];
+    }
+    s.avg_waiting = (double)sum_w / s.num_tasks;
+    s.avg_turnaround = (double)sum_t / s.num_tasks;
+    s.avg_response = (double)sum_r / s.num_tasks;
+    s.makespan = last_finish - first_arrival;
+    if (s.makespan > 0)
+        s.throughput = s.num_tasks * 1e6 / s.makespan;
+    percentiles(waiting, s.waiting_pct);
+    percentiles(turnaround, s.turnaround_pct);
+    percentiles(response, s.response_pct);
+    return s;
+}
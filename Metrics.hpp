@@ -0,0 +1,61 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "Task.hpp"
+#include <vector>
+#include <string>
+
+// in-process version of metrics.py, so a run does not need its logs.
+// the per-task timestamps travel inside Task. they are written only by the
+// thread holding the task, so ENTER_SCHED must be recorded before the task is
+// handed to a runqueue another cpu can take it from. each cpu appends finished
+// tasks to its own accumulator and the accumulators are merged once every cpu
+// has stopped.
+
+struct TaskRecord {
+    int task_id;
+    long long arrival;      // first ENTER_SCHED
+    long long waiting;      // sum of ENTER_CPU - previous ENTER_SCHED
+    long long turnaround;   // FINISH - first ENTER_SCHED
+    long long response;     // first ENTER_CPU - first ENTER_SCHED
+};
+
+class MetricsAccumulator {
+    std::vector<TaskRecord> records;
+    long long resumed_bursts;   // CPU bursts after a task's first one
+    long long warm_bursts;      // ... that ran on the same cpu as the previous one
+
+public:
+    MetricsAccumulator();
+    // timestamps in us since Simulation::start_time, same clock as the logs
+    void enter_sched(Task *task, long long now_us);
+    void enter_cpu(Task *task, long long now_us);
+    void finish(Task *task, long long now_us);
+    // a CPU burst starts on cpu_id, call before task->last_cpu is updated
+    void cpu_burst(const Task *task, int cpu_id);
+    const std::vector<TaskRecord> &get_records() const;
+    long long get_resumed_bursts() const;
+    long long get_warm_bursts() const;
+};
+
+struct MetricsSummary {
+    int num_tasks;
+    double avg_waiting, avg_turnaround, avg_response;
+    // percentiles, index 0/1/2 = p50/p95/p99
+    long long waiting_pct[3], turnaround_pct[3], response_pct[3];
+    // first arrival to last finish, in us
+    long long makespan;
+    double throughput;          // tasks per second over the makespan
+    // cache warmth = warm_bursts / resumed_bursts
+    long long resumed_bursts, warm_bursts;
+    double cache_warmth;
+    // filled in by Scheduler_EDF, misses are counted among admitted tasks
+    int deadline_admitted, deadline_rejected, deadline_missed;
+
+    MetricsSummary();
+    std::string to_string() const;
+};
+
+MetricsSummary merge_metrics(const MetricsAccumulator *acc, int n);
+
+#endif
@@ -1,15 +1,31 @@
 #ifndef SCHEDULER_HPP
 #define SCHEDULER_HPP
 
+#include <chrono>
 #include "Task.hpp"
 #include "Logger.hpp"
 
+// how much of the trace the schedulers keep loaded
+// (workload_factor1 / workload_factor2 on the command line)
+struct Workload {
+    int target;     // read more tasks while a ready queue holds fewer than this
+    int batch;      // tasks read per refill
+};
+
 class Scheduler {
 public:
     Scheduler() {}
     virtual Task* request_task(int cpu_id, Logger &logger) = 0;
     virtual void return_task(int cpu_id, Task *task) = 0;
     virtual void read_next_n_tasks(int n, int cpu_id, Logger &logger) = 0;
+    // lock-free hint for monitoring, may be slightly stale
+    virtual int runqueue_length(int cpu_id) const = 0;
+    // called by the cpu that saw the task's last burst, right before it is deleted
+    virtual void finish_task(int /*cpu_id*/, Task * /*task*/) {}
+    // the run's clock (logs, metrics, io timers), called before any cpu starts
+    virtual void set_start_time(std::chrono::steady_clock::time_point /*t0*/) {}
+    // scheduler specific counters for the end of run summary, called after every cpu stopped
+    virtual void add_to_summary(MetricsSummary & /*summary*/) const {}
     virtual ~Scheduler() {}
 };
 
@@ -0,0 +1,193 @@
+#include "Scheduler_EDF.hpp"
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <stdexcept>
+#include <mutex>
+using namespace std;
+
+
+bool Scheduler_EDF::DeadlineLater::operator()(const Task *a, const Task *b) const {
+    if (a->abs_deadline != b->abs_deadline)
+        return a->abs_deadline > b->abs_deadline;
+    return a->task_id > b->task_id;
+}
+
+Scheduler_EDF::Runqueue::Runqueue()
+    : utilization(0.0), len(0)
+    {}
+
+Scheduler_EDF::Scheduler_EDF(string filename, int NUM_CPU, const Workload &workload)
+    : num_cpu(NUM_CPU), workload(workload), start_time(chrono::steady_clock::now()),
+      num_admitted(0), num_rejected(0), num_missed(0)
+{
+    // before allocating, a bad trace throws without leaking
+    if (!open_task_file(filename)){
+        throw runtime_error("infile error");
+    }
+    cpu_rq = new Scheduler_EDF::Runqueue[NUM_CPU];
+}
+
+Scheduler_EDF::~Scheduler_EDF(){
+    for (int i = 0; i < num_cpu; ++i){
+        while (!cpu_rq[i].deadline_heap.empty()){
+            delete cpu_rq[i].deadline_heap.top();
+            cpu_rq[i].deadline_heap.pop();
+        }
+        while (!cpu_rq[i].best_effort.empty()){
+            delete cpu_rq[i].best_effort.front();
+            cpu_rq[i].best_effort.pop();
+        }
+    }
+    delete [] cpu_rq;
+}
+
+void Scheduler_EDF::add_to_summary(MetricsSummary &summary) const {
+    summary.deadline_admitted = num_admitted;
+    summary.deadline_rejected = num_rejected;
+    summary.deadline_missed = num_missed;
+}
+
+Task* Scheduler_EDF::request_task(int cpu_id, Logger &logger){
+    // maintain system workload
+    if (cpu_rq[cpu_id].len.load() < workload.target){
+        read_next_n_tasks(workload.batch, cpu_id, logger);
+    }
+
+    Runqueue &rq = cpu_rq[cpu_id];
+    Task *task = nullptr;
+    rq.rq_mutex.lock();
+    if (!rq.deadline_heap.empty()){
+        task = rq.deadline_heap.top();
+        rq.deadline_heap.pop();
+    } else if (!rq.best_effort.empty()){
+        task = rq.best_effort.front();
+        rq.best_effort.pop();
+    }
+    if (task) rq.len -= 1;
+    rq.rq_mutex.unlock();
+    return task;
+}
+
+// admitted tasks only ever come back to the cpu they were admitted to
+void Scheduler_EDF::return_task(int cpu_id, Task *task){
+    insert_task(cpu_id, task);
+}
+
+void Scheduler_EDF::insert_task(int cpu_id, Task *task){
+    Runqueue &rq = cpu_rq[cpu_id];
+    rq.rq_mutex.lock();
+    if (task->abs_deadline >= 0)
+        rq.deadline_heap.push(task);
+    else
+        rq.best_effort.push(task);
+    rq.len += 1;
+    rq.rq_mutex.unlock();
+}
+
+void Scheduler_EDF::set_start_time(chrono::steady_clock::time_point t0){
+    start_time = t0;
+}
+
+long long Scheduler_EDF::now_us() const {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start_time).count();
+}
+
+int Scheduler_EDF::runqueue_length(int cpu_id) const {
+    return cpu_rq[cpu_id].len.load(memory_order_relaxed);
+}
+
+// worst-fit utilization test, caller holds sched_mutex
+int Scheduler_EDF::admit(Task *task){
+    int period = (task->period > 0) ? task->period : task->deadline;
+    double u = (double)task->cpu_time() / period;
+    int best = -1;
+    for (int i = 0; i < num_cpu; ++i){
+        if (task->cpu_affinity >= 0 && i != task->cpu_affinity) continue;
+        if (cpu_rq[i].utilization + u > 1.0) continue;
+        if (best < 0 || cpu_rq[i].utilization < cpu_rq[best].utilization)
+            best = i;
+    }
+    if (best >= 0){
+        cpu_rq[best].utilization += u;
+        admitted[task->task_id] = pair<int, double>(best, u);
+    }
+    return best;
+}
+
+// same rule as Scheduler_O1: hard affinity, then the cpu of the first burst
+// unless it already holds a full workload, then the reading cpu
+int Scheduler_EDF::place(Task *task, int cpu_id){
+    if (task->cpu_affinity >= 0) return task->cpu_affinity;
+    int device = task->bursts.front().first;
+    if (device < IO_ID_OFFSET){
+        int preferred = device % num_cpu;
+        if (cpu_rq[preferred].len.load() < workload.target) return preferred;
+    }
+    return cpu_id;
+}
+
+void Scheduler_EDF::finish_task(int cpu_id, Task *task){
+    cpu_id += 1; // prevent warning
+    if (task->abs_deadline < 0) return;
+    long long now = now_us();
+    sched_mutex.lock();
+    auto it = admitted.find(task->task_id);
+    if (it != admitted.end()){
+        cpu_rq[it->second.first].utilization -= it->second.second;
+        admitted.erase(it);
+    }
+    if (now > task->abs_deadline)
+        num_missed += 1;
+    sched_mutex.unlock();
+}
+
+
+bool Scheduler_EDF::open_task_file(const string &filename){
+    infile.open(filename);
+    if (!infile){
+        cerr << "Cannot open file: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+void Scheduler_EDF::read_next_n_tasks(int n, int cpu_id, Logger &logger){
+    sched_mutex.lock();
+    if (!infile.is_open()){
+        sched_mutex.unlock();
+        return;
+    }
+    string line;
+    int count = 0;
+
+    while (count < n && getline(infile, line)){
+        Task *task = parse_task(line);
+        if (task->cpu_affinity >= 0) task->cpu_affinity %= num_cpu;
+        logger.write("SCHED", cpu_id, task, "ENTER_SCHED");
+        if (task->bursts.empty()){
+            throw runtime_error("no bursts @ ENTER_SCHED");
+        }
+
+        int target = place(task, cpu_id);
+        if (task->deadline > 0){
+            logger.write("SCHED", cpu_id, task->task_id, "DEADLINE", to_string(task->deadline));
+            int cpu = admit(task);
+            if (cpu >= 0){
+                task->abs_deadline = now_us() + task->deadline;
+                target = cpu;
+                num_admitted += 1;
+            } else {
+                logger.write("SCHED", cpu_id, task->task_id, "REJECT");
+                num_rejected += 1;
+            }
+        }
+        insert_task(target, task);
+        count += 1;
+    }
+
+    if (infile.eof()){
+        infile.close();
+    }
+    sched_mutex.unlock();
+}
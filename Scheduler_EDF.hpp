@@ -0,0 +1,67 @@
+#ifndef SCHEDULER_EDF_HPP
+#define SCHEDULER_EDF_HPP
+
+#include "Scheduler.hpp"
+#include <vector>
+#include <queue>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+using namespace std;
+
+// partitioned earliest-deadline-first:
+// tasks with a deadline are admitted to the cpu with the lowest utilization
+// that stays <= 1, and run in deadline order on that cpu only.
+// rejected tasks and tasks without a deadline run FIFO after them.
+// a task with hard affinity is only ever admitted to / queued on that cpu.
+class Scheduler_EDF : public Scheduler{
+
+    ifstream infile;
+    mutex sched_mutex;       // infile, admitted, counters
+
+    struct DeadlineLater{
+        bool operator()(const Task *a, const Task *b) const;
+    };
+
+    struct Runqueue{
+        priority_queue<Task*, vector<Task*>, DeadlineLater> deadline_heap;
+        queue<Task*> best_effort;
+        double utilization;  // sum of cpu_time / period of admitted tasks
+        atomic<int> len;
+        mutex rq_mutex;
+        Runqueue();
+    };
+    Runqueue *cpu_rq;
+    int num_cpu;
+    Workload workload;
+    chrono::steady_clock::time_point start_time;  // abs_deadline is us since this, the run's clock
+
+    // task_id -> (cpu, utilization) of admitted tasks, released on finish
+    unordered_map<int, pair<int, double>> admitted;
+    int num_admitted, num_rejected, num_missed;
+
+public:
+    Scheduler_EDF(string filename, int NUM_CPU, const Workload &workload);
+    Task* request_task(int cpu_id, Logger &logger) override;
+    void return_task(int cpu_id, Task *task) override;
+    void read_next_n_tasks(int n, int cpu_id, Logger &logger) override;
+    int runqueue_length(int cpu_id) const override;
+    void finish_task(int cpu_id, Task *task) override;
+    void set_start_time(chrono::steady_clock::time_point t0) override;
+    void add_to_summary(MetricsSummary &summary) const override;
+    ~Scheduler_EDF();
+private:
+    bool open_task_file(const string &filename);
+    // returns the cpu the task is admitted to, -1 if it does not fit anywhere
+    int admit(Task *task);
+    // runqueue a task that is not admitted goes to
+    int place(Task *task, int cpu_id);
+    void insert_task(int cpu_id, Task *task);
+    long long now_us() const;
+};
+
+#endif
@@ -7,10 +7,6 @@
 #include <mutex>
 using namespace std;
 
-extern int NUM_CPU;
-extern int workload_factor1;
-extern int workload_factor2;
-
 Scheduler_O1::PriorityQueue::PriorityQueue()
     : pq(140), len(0)
     {}
@@ -44,19 +40,22 @@ int Scheduler_O1::PriorityQueue::size() const {
     return this->len;
 }
 
-Scheduler_O1::Runqueue::Runqueue() {}
+Scheduler_O1::Runqueue::Runqueue()
+    : len(0)
+    {}
 
 int Scheduler_O1::Runqueue::size() const {
-    return active_pq.size() + expired_pq.size();
+    return len.load(memory_order_relaxed);
 }
 
-Scheduler_O1::Scheduler_O1(string filename, int NUM_CPU){
-
-    cpu_rq = new Scheduler_O1::Runqueue[NUM_CPU];
-
+Scheduler_O1::Scheduler_O1(string filename, int NUM_CPU, const Workload &workload)
+    : num_cpu(NUM_CPU), workload(workload)
+{
+    // before allocating, a bad trace throws without leaking
     if (!open_task_file(filename)){
         throw runtime_error("infile error");
     }
+    cpu_rq = new Scheduler_O1::Runqueue[NUM_CPU];
 }
 
 Scheduler_O1::~Scheduler_O1(){
@@ -65,30 +64,53 @@ Scheduler_O1::~Scheduler_O1(){
 
 Task* Scheduler_O1::request_task(int cpu_id, Logger &logger){
     // maintain system workload
-    if (cpu_rq[cpu_id].size() < workload_factor1){
-        read_next_n_tasks(workload_factor2, cpu_id, logger);
+    if (cpu_rq[cpu_id].size() < workload.target){
+        read_next_n_tasks(workload.batch, cpu_id, logger);
     }
 
-    Task *task = cpu_rq[cpu_id].active_pq.get();
-    if (task != nullptr){
-        return task;
+    Runqueue &rq = cpu_rq[cpu_id];
+    rq.rq_mutex.lock();
+    Task *task = rq.active_pq.get();
+    if (task == nullptr){
+        swap(rq.active_pq, rq.expired_pq);
+        task = rq.active_pq.get();
     }
-    swap(cpu_rq[cpu_id].active_pq, cpu_rq[cpu_id].expired_pq);
-    task = cpu_rq[cpu_id].active_pq.get();
-    if (task != nullptr){
-        return task;
-    }
-    return nullptr;
+    if (task) rq.len -= 1;
+    rq.rq_mutex.unlock();
+    return task;
 }
 
-// return tasks to expired_pq
+int Scheduler_O1::runqueue_length(int cpu_id) const {
+    return cpu_rq[cpu_id].size();
+}
+
+// return tasks to expired_pq, always on the cpu that ran them (keeps caches warm)
 void Scheduler_O1::return_task(int cpu_id, Task *task){
-    cpu_rq[cpu_id].expired_pq.insert(task);
-    
+    Runqueue &rq = cpu_rq[cpu_id];
+    rq.rq_mutex.lock();
+    rq.expired_pq.insert(task);
+    rq.len += 1;
+    rq.rq_mutex.unlock();
 }
 // insert tasks to active_pq
 void Scheduler_O1::insert_task(int cpu_id, Task *task){
-    cpu_rq[cpu_id].active_pq.insert(task);
+    Runqueue &rq = cpu_rq[cpu_id];
+    rq.rq_mutex.lock();
+    rq.active_pq.insert(task);
+    rq.len += 1;
+    rq.rq_mutex.unlock();
+}
+
+// hard affinity first, then the cpu the first burst names unless it already
+// holds a full workload, then the cpu that read the task
+int Scheduler_O1::place(Task *task, int cpu_id){
+    if (task->cpu_affinity >= 0) return task->cpu_affinity;
+    int device = task->bursts.front().first;
+    if (device < IO_ID_OFFSET){
+        int preferred = device % num_cpu;
+        if (cpu_rq[preferred].size() < workload.target) return preferred;
+    }
+    return cpu_id;
 }
 
 
@@ -111,22 +133,15 @@ void Scheduler_O1::read_next_n_tasks(int n, int cpu_id, Logger &logger){
     int count = 0;
 
     while (count < n && getline(infile, line)){
-        istringstream iss(line);
-        int task_id, rt_priority, nice, policy;
-        iss >> task_id >> rt_priority >> nice >> policy;
-
-        vector<pair<int, int>> bursts;
-        int device_id, duration;
-        while (iss >> device_id >> duration){
-            bursts.push_back(pair<int,int>(device_id, duration));
-        }
-
-        Task *task = new Task(task_id, rt_priority, nice, policy, bursts);
-        logger.write("SCHED", cpu_id, task->task_id, "ENTER_SCHED");
+        Task *task = parse_task(line);
+        if (task->cpu_affinity >= 0) task->cpu_affinity %= num_cpu;
+        logger.write("SCHED", cpu_id, task, "ENTER_SCHED");
+        if (task->deadline > 0)
+            logger.write("SCHED", cpu_id, task->task_id, "DEADLINE", to_string(task->deadline));
         if (task->bursts.empty()){
             throw runtime_error("no bursts @ ENTER_SCHED");
         }
-        insert_task(cpu_id, task);
+        insert_task(place(task, cpu_id), task);
         count += 1;
     }
     
@@ -12,6 +12,7 @@
 #include <utility>
 #include <bitset>
 #include <mutex>
+#include <atomic>
 using namespace std;
 
 
@@ -35,20 +36,27 @@ class Scheduler_O1 : public Scheduler{
     
     struct Runqueue{
         PriorityQueue active_pq, expired_pq;
+        atomic<int> len;
+        mutex rq_mutex;      // other cpus insert newly read tasks here
         Runqueue();
         int size() const;
     };
     Runqueue *cpu_rq;
+    int num_cpu;
+    Workload workload;
     
 public:
-    Scheduler_O1(std::string filename, int NUM_CPU);
+    Scheduler_O1(std::string filename, int NUM_CPU, const Workload &workload);
     Task* request_task(int cpu_id, Logger &logger) override;
     void return_task(int cpu_id, Task *task) override;
     void read_next_n_tasks(int n, int cpu_id, Logger &logger) override;
+    int runqueue_length(int cpu_id) const override;
     void insert_task(int cpu_id, Task *task);
     ~Scheduler_O1();
 private:
     bool open_task_file(const string &filename);
+    // runqueue a newly read task goes to
+    int place(Task *task, int cpu_id);
 };
 
 #endif
\ No newline at end of file
@@ -6,11 +6,9 @@
 #include <stdexcept>
 using namespace std;
 
-extern int NUM_CPU;
-extern int workload_factor1;
-extern int workload_factor2;
-
-Scheduler_On::Scheduler_On(string filename){
+Scheduler_On::Scheduler_On(string filename, int NUM_CPU, const Workload &workload)
+    : rq_len(0), num_cpu(NUM_CPU), workload(workload)
+{
     if (!open_task_file(filename)){
         throw runtime_error("infile error");
     }
@@ -18,9 +16,7 @@ Scheduler_On::Scheduler_On(string filename){
 
 Scheduler_On::~Scheduler_On(){
     rq_mutex.lock();
-    while (!ready_queue.empty()){
-        Task *task = ready_queue.front();
-        ready_queue.pop_front();
+    for (Task *task: ready_queue.tasks){
         delete task;
     }
     rq_mutex.unlock();
@@ -28,54 +24,38 @@ Scheduler_On::~Scheduler_On(){
 
 Task* Scheduler_On::request_task(int cpu_id, Logger &logger){
     rq_mutex.lock();
-    if ((int)ready_queue.size() < workload_factor1) 
-        read_next_n_tasks(workload_factor2, cpu_id, logger);
+    if ((int)ready_queue.size() < workload.target) 
+        read_next_n_tasks(workload.batch, cpu_id, logger);
 
 
-    if (ready_queue.empty()){
+    // O(n) time to select next task, vectorized over the SoA ready queue
+    // -1: empty, or everything left is pinned to other cpus
+    int best = goodness_argmax(ready_queue, cpu_id);
+    if (best < 0){
         rq_mutex.unlock();
         return nullptr;
     }
-    pair<int, Task*> best_choice(-2000, nullptr);
-    // O(n) time to select next task
-    for (Task *task: ready_queue){    
-        int good_val = goodness(cpu_id, task);
-        if (good_val > best_choice.first){
-            best_choice.first = good_val;
-            best_choice.second = task;
-        }
-    }
-    ready_queue.remove(best_choice.second);
+    Task *task = ready_queue.tasks[best];
+    ready_queue.erase(best);
+    rq_len.store(ready_queue.size(), memory_order_relaxed);
 
     rq_mutex.unlock();
-    return best_choice.second;
+    return task;
 }
 
 void Scheduler_On::return_task(int cpu_id, Task *task){
     cpu_id += 1; // prevent warning
     rq_mutex.lock();
     ready_queue.push_back(task);
+    rq_len.store(ready_queue.size(), memory_order_relaxed);
     rq_mutex.unlock();
 }
 
-int Scheduler_On::goodness(const int cpu_id, const Task *task) const {
-    int task_cpu_id = task->bursts.front().first;
-    int remaining_time = task->bursts.front().second;
-
-    if (task->policy){ // policy == 1 || == 2
-        // low priority tasks (high priority value) runs first
-        return 1000 + task->rt_priority; 
-    }
-
-    int weight = remaining_time;
-    if (task_cpu_id == cpu_id){
-        weight += 1;
-    }
-    weight += 20 - task->nice;
-    return weight;
+int Scheduler_On::runqueue_length(int cpu_id) const {
+    cpu_id += 1; // prevent warning
+    return rq_len.load(memory_order_relaxed);
 }
 
-
 bool Scheduler_On::open_task_file(const string &filename){
     infile.open(filename);
     if (!infile){
@@ -95,19 +75,11 @@ void Scheduler_On::read_next_n_tasks(int n, int cpu_id, Logger &logger){
     int count = 0;
 
     while (count < n && getline(infile, line)){
-        istringstream iss(line);
-        int task_id, rt_priority, nice, policy;
-        iss >> task_id >> rt_priority >> nice >> policy;
-
-        vector<pair<int, int>> bursts;
-        int device_id, duration;
-        while (iss >> device_id >> duration){
-            bursts.push_back(pair<int, int>(device_id, duration));
-            //cerr << task_id << " " << duration << endl;
-        }
-
-        Task *task = new Task(task_id, rt_priority, nice, policy, bursts);
-        logger.write("SCHED", cpu_id, task->task_id, "ENTER_SCHED");
+        Task *task = parse_task(line);
+        if (task->cpu_affinity >= 0) task->cpu_affinity %= num_cpu;
+        logger.write("SCHED", cpu_id, task, "ENTER_SCHED");
+        if (task->deadline > 0)
+            logger.write("SCHED", cpu_id, task->task_id, "DEADLINE", to_string(task->deadline));
         return_task(-1, task);
         count += 1;
     }
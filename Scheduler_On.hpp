@@ -2,8 +2,8 @@
 #define SCHEDULER_ON_HPP
 
 #include "Scheduler.hpp"
+#include "GoodnessKernel.hpp"
 #include <queue>
-#include <list>
 #include <string>
 #include <pthread.h>
 #include <fstream>
@@ -11,20 +11,24 @@
 #include <iostream>
 #include <utility>
 #include <mutex>
+#include <atomic>
 
 class Scheduler_On : public Scheduler{
-    std::list<Task*> ready_queue;
+    ReadyQueueSoA ready_queue;
     int seed;
     std::ifstream infile;
     std::recursive_mutex rq_mutex;
+    std::atomic<int> rq_len;
+    int num_cpu;
+    Workload workload;
 public:
-    Scheduler_On(std::string filename);
+    Scheduler_On(std::string filename, int NUM_CPU, const Workload &workload);
     ~Scheduler_On();
     Task* request_task(int cpu_id, Logger &logger) override;
     void return_task(int cpu_id, Task *task) override;
     void read_next_n_tasks(int n, int cpu_id, Logger &logger) override;
+    int runqueue_length(int cpu_id) const override;
 private:
-    int goodness(const int cpu_id, const Task *task) const ;
     bool open_task_file(const std::string &filename);
 };
 
@@ -0,0 +1,491 @@
+#include "Simulation.hpp"
+#include <iostream>
+#include <pthread.h>
+#include <stdexcept>
+#include <algorithm>
+#include "Scheduler_On.hpp"
+#include "Scheduler_O1.hpp"
+#include "Scheduler_EDF.hpp"
+#include "ThreadUtils.hpp"
+#include "TimerWheel.hpp"
+#include "Logger.hpp"
+
+using namespace std;
+
+const int STATS_IDLE_PUBLISH_US = 1000;
+
+static mutex cerr_mutex;
+
+static uint64_t elapsed_us(chrono::steady_clock::time_point from, chrono::steady_clock::time_point to){
+    return chrono::duration_cast<chrono::microseconds>(to - from).count();
+}
+
+// small safe print function to avoid interleaved cerr
+static void safe_cerr(const string &s){
+    cerr_mutex.lock();
+    cerr << s << flush;
+    cerr_mutex.unlock();
+}
+
+SimConfig::SimConfig()
+    : num_cpu(4), num_io(2), io_depth(1), workload{16, 1},
+      coro_workers(0), logging(true), stats(true)
+    {}
+
+Scheduler *make_scheduler(const string &algo, const string &filename,
+                          int num_cpu, const Workload &workload){
+    if (algo == "On") return new Scheduler_On(filename, num_cpu, workload);
+    if (algo == "O1") return new Scheduler_O1(filename, num_cpu, workload);
+    if (algo == "EDF") return new Scheduler_EDF(filename, num_cpu, workload);
+    return nullptr;
+}
+
+Simulation::Simulation(const SimConfig &config)
+    : config(config), shut_down(false)
+{
+    sched = make_scheduler(config.algo, config.trace, config.num_cpu, config.workload);
+    if (!sched){
+        throw runtime_error("unknown scheduler " + config.algo);
+    }
+
+    int num_cpu = config.num_cpu, num_io = config.num_io;
+    cpu_state = new atomic<bool>[num_cpu];
+    tasks_return_from_io = new queue<Task*>[num_cpu];
+    ret_mutex = new mutex[num_cpu];
+    io_queue = new queue<pair<int, Task*>>[num_io];
+    io_mutex = new mutex[num_io];
+    io_running = new atomic<bool>[num_io];
+    cpu_metrics = new MetricsAccumulator[num_cpu];
+    sched_ns = new long long[num_cpu]();
+    sched_calls = new long long[num_cpu]();
+    // CPUs count as running until they find nothing to do, otherwise an IO
+    // device that starts first sees every CPU idle and shuts the run down
+    for (int i = 0; i < num_cpu; ++i) cpu_state[i].store(true);
+    for (int i = 0; i < num_io; ++i) io_running[i].store(false);
+
+    // live stats segment, the run continues without it if shm is unavailable
+    if (config.stats) stats.create(num_cpu, num_io);
+}
+
+Simulation::~Simulation(){
+    delete sched;
+    delete [] cpu_metrics;
+    delete [] sched_ns;
+    delete [] sched_calls;
+    delete [] cpu_state;
+    delete [] tasks_return_from_io;
+    delete [] ret_mutex;
+    delete [] io_queue;
+    delete [] io_mutex;
+    delete [] io_running;
+}
+
+SimResult Simulation::run(){
+    // set time
+    start_time = chrono::steady_clock::now();
+    sched->set_start_time(start_time);
+
+    if (config.coro_workers > 0){
+        // coroutine mode: every device is a Job on a small worker pool
+        CoroRuntime runtime(config.coro_workers);
+        for (int i = 0; i < config.num_io; ++i)
+            runtime.spawn(IO_device(i));
+        for (int i = 0; i < config.num_cpu; ++i)
+            runtime.spawn(processor(i));
+        runtime.run();
+    } else {
+        run_threads();
+    }
+
+    // every cpu has stopped, its counters are safe to read
+    SimResult result;
+    result.metrics = merge_metrics(cpu_metrics, config.num_cpu);
+    sched->add_to_summary(result.metrics);
+    result.sched_ns.assign(sched_ns, sched_ns + config.num_cpu);
+    result.sched_calls.assign(sched_calls, sched_calls + config.num_cpu);
+    return result;
+}
+
+// -------------------- I/O device --------------------
+// a device keeps up to io_depth requests in flight, each one completes on its
+// own when its burst is over; io_depth = 1 is a plain serial device
+struct IoRequest {
+    TimerNode timer;
+    int cpu_id;
+    Task *task;
+};
+
+Job Simulation::IO_device(int io_id){
+    //safe_cerr("Turn on I/O #" + to_string(io_id) + "\n");
+    // init Logger
+    Logger logger("io" + to_string(io_id) + ".log", start_time, config.logging);
+    // let the file be opened before running time
+    logger.write("IO", io_id, -1, "INIT");
+    co_await sleep_for(10000);
+
+    // completions are tracked in us since start_time
+    TimerWheel inflight(elapsed_us(start_time, chrono::steady_clock::now()));
+    vector<IoRequest> requests(config.io_depth);
+    vector<IoRequest*> free_requests;
+    for (auto &req : requests){
+        req.timer.data = &req;
+        free_requests.push_back(&req);
+    }
+    vector<pair<int, Task*>> accepted;
+    vector<TimerNode*> completed;
+
+    SeqSlot<IoCounters> *slot = stats.io(io_id);
+    IoCounters counters{};
+    auto idle_since = chrono::steady_clock::now();
+    auto busy_start = idle_since;
+    auto last_publish = idle_since;
+
+    while (true){
+        // lock this device's mutex and take as many tasks as there are free slots
+        io_mutex[io_id].lock();
+        while (accepted.size() < free_requests.size() && !io_queue[io_id].empty()){
+            accepted.push_back(io_queue[io_id].front());
+            io_queue[io_id].pop();
+        }
+        counters.queue_depth = io_queue[io_id].size();
+        io_mutex[io_id].unlock();
+
+        auto now = chrono::steady_clock::now();
+        uint64_t now_us = elapsed_us(start_time, now);
+        if (!accepted.empty() && inflight.size() == 0){
+            io_running[io_id].store(true);
+            busy_start = now;
+            counters.idle_us += elapsed_us(idle_since, busy_start);
+        }
+        for (auto &temp : accepted){
+            Task *task = temp.second;
+            if (!task){
+                safe_cerr("IO_device: null task pointer!\n");
+                continue;
+            }
+
+            if (task->bursts.empty()){
+                throw runtime_error("no task duration time in IO_device");
+            }
+
+            auto job_type = task->bursts.front();
+            int duration = job_type.second;
+            logger.write("IO", io_id, task->task_id, "ENTER_IO");
+            if (duration <= 0) throw runtime_error("duration time error in IO_device");
+
+            IoRequest *req = free_requests.back();
+            free_requests.pop_back();
+            req->cpu_id = temp.first;
+            req->task = task;
+            inflight.insert(&req->timer, now_us + duration);
+        }
+        accepted.clear();
+        counters.in_flight = inflight.size();
+
+        // every request whose burst is over goes back to its cpu
+        inflight.advance(now_us, completed);
+        for (TimerNode *node : completed){
+            IoRequest *req = (IoRequest*)node->data;
+            int cpu_id = req->cpu_id;
+            Task *task = req->task;
+            free_requests.push_back(req);
+
+            task->bursts.pop_front();
+            logger.write("IO", io_id, task->task_id, "LEAVE_IO");//, to_string(duration));
+            counters.served += 1;
+
+            // return to CPU queue: lock that cpu's queue mutex
+            if (cpu_id < 0 || cpu_id >= config.num_cpu){
+                safe_cerr("IO_device: invalid cpu_id returned: " + to_string(cpu_id) + "\n");
+                continue;
+            }
+            ret_mutex[cpu_id].lock();
+            tasks_return_from_io[cpu_id].push(task);
+            ret_mutex[cpu_id].unlock();
+        }
+        if (!completed.empty()){
+            completed.clear();
+            counters.in_flight = inflight.size();
+            now = chrono::steady_clock::now();
+            if (inflight.size() == 0){
+                idle_since = now;
+                counters.busy_us += elapsed_us(busy_start, idle_since);
+            }
+            if (slot){
+                slot->store(counters);
+                last_publish = now;
+            }
+        }
+
+        if (inflight.size() > 0){
+            if (free_requests.empty()){
+                // saturated: nothing can change before the earliest completion
+                uint64_t earliest = inflight.next_expiry();
+                co_await sleep_for(earliest > now_us ? earliest - now_us : 0);
+            } else {
+                co_await yield_now();
+            }
+            continue;
+        }
+
+        io_mutex[io_id].lock();
+        bool has_task = !io_queue[io_id].empty();
+        io_mutex[io_id].unlock();
+        if (has_task) continue;
+
+        io_running[io_id].store(false);
+        now = chrono::steady_clock::now();
+        if (slot && elapsed_us(last_publish, now) >= STATS_IDLE_PUBLISH_US){
+            counters.queue_depth = 0;
+            counters.idle_us += elapsed_us(idle_since, now);
+            idle_since = now;
+            slot->store(counters);
+            last_publish = now;
+        }
+
+        // check shutdown condition:
+        bool all_not_running = true;
+        for (int i = 0; i < config.num_cpu; ++i){
+            all_not_running &= !cpu_state[i].load();
+        }
+        if (all_not_running){
+            if (slot){
+                counters.idle_us += elapsed_us(idle_since, chrono::steady_clock::now());
+                slot->store(counters);
+            }
+            shut_down.store(true);
+            //safe_cerr("Shut down I/O #" + to_string(io_id) + "\n");
+            break;
+        }
+        co_await yield_now();
+    }
+}
+
+// -------------------- CPU --------------------
+Job Simulation::processor(int cpu_id){
+    //safe_cerr("Turn on CPU #" + to_string(cpu_id) + "\n");
+
+    // init Logger
+    Logger logger("cpu" + to_string(cpu_id) + ".log", start_time, config.logging);
+    logger.set_metrics(&cpu_metrics[cpu_id]);
+    logger.write("CPU", cpu_id, -1, "INIT");
+    co_await sleep_for(10000);
+
+    SeqSlot<CpuCounters> *slot = stats.cpu(cpu_id);
+    CpuCounters counters{};
+    uint64_t idle_ns = 0;   // idle polls are sub-microsecond, accumulate in ns
+    auto last_publish = chrono::steady_clock::now();
+    cpu_state[cpu_id].store(true);
+    // preload n tasks to create a stable workload
+    sched->read_next_n_tasks(config.workload.target, cpu_id, logger);
+
+    while (true){
+        // drain returned tasks safely under lock
+        ret_mutex[cpu_id].lock();
+        while (!tasks_return_from_io[cpu_id].empty()){
+            Task *ret_task = tasks_return_from_io[cpu_id].front();
+            tasks_return_from_io[cpu_id].pop();
+            ret_mutex[cpu_id].unlock();
+
+            if (!ret_task){
+                safe_cerr("processor: null ret_task\n");
+            } else if (!(ret_task->bursts.empty())){
+                // record before return_task: once queued, another cpu may run or delete it
+                logger.write("CPU", cpu_id, ret_task, "ENTER_SCHED");
+                sched->return_task(cpu_id, ret_task);
+            } else {
+                // end of task
+                logger.write("CPU", cpu_id, ret_task, "FINISH_IO");
+                sched->finish_task(cpu_id, ret_task);
+                delete ret_task;
+            }
+
+            ret_mutex[cpu_id].lock();
+        }
+        ret_mutex[cpu_id].unlock();
+
+        // request a task from scheduler
+        auto start = chrono::steady_clock::now();
+        Task *task = sched->request_task(cpu_id, logger);
+        auto finish = chrono::steady_clock::now();
+        long long pick_ns = chrono::duration_cast<chrono::nanoseconds>(finish - start).count();
+        sched_ns[cpu_id] += pick_ns;
+        sched_calls[cpu_id] += 1;
+        counters.pick_latency[latency_bucket(pick_ns)] += 1;
+        counters.runqueue_len = sched->runqueue_length(cpu_id);
+        if (!task){
+            auto now = chrono::steady_clock::now();
+            idle_ns += chrono::duration_cast<chrono::nanoseconds>(now - start).count();
+            counters.idle_us = idle_ns / 1000;
+            if (slot && elapsed_us(last_publish, now) >= STATS_IDLE_PUBLISH_US){
+                slot->store(counters);
+                last_publish = now;
+            }
+
+            // check IO queues and returned task queues under proper locks
+            bool all_io_empty = true;
+            for (int i = 0; i < config.num_io; ++i){
+                io_mutex[i].lock();
+                all_io_empty &= io_queue[i].empty();
+                io_mutex[i].unlock();
+            }
+
+            bool all_ret_empty = true;
+            for (int i = 0; i < config.num_cpu; ++i){
+                ret_mutex[i].lock();
+                all_ret_empty &= tasks_return_from_io[i].empty();
+                ret_mutex[i].unlock();
+            }
+
+            // tasks placed on another cpu's runqueue (or pinned to one) are still work
+            bool all_rq_empty = true;
+            for (int i = 0; i < config.num_cpu; ++i){
+                all_rq_empty &= sched->runqueue_length(i) == 0;
+            }
+
+            // check if any IO is still working
+            bool any_io_busy = false;
+            for (int i = 0; i < config.num_io; ++i){
+                any_io_busy |= io_running[i];
+            }
+
+            if (all_io_empty && !any_io_busy && all_ret_empty && all_rq_empty){
+                cpu_state[cpu_id].store(false); // tell IOs this cpu is idle
+            } else {
+                cpu_state[cpu_id].store(true);
+            }
+
+            if (shut_down.load()){
+                //safe_cerr("Shut down cpu #" + to_string(cpu_id) + "\n");
+                break;
+            }
+            co_await yield_now();
+            continue;
+        }
+
+        if (task->bursts.empty()){
+            //cerr << "no time " << task->task_id << endl;
+            //continue;
+            throw runtime_error("no task duration time in processor");
+        }
+        auto job_type = task->bursts.front();
+        int device_id = job_type.first;
+        int duration = job_type.second;
+        counters.dispatched += 1;
+
+        bool run = false;
+        // CPU work
+        logger.write("CPU", cpu_id, task, "ENTER_CPU");
+        if (device_id < IO_ID_OFFSET){
+            //logger.write("CPU", cpu_id, task->task_id, "ENTER_CPU");
+
+            if (duration <= 0){
+                //continue;
+                throw runtime_error("duration time error in processor");
+            }
+            cpu_metrics[cpu_id].cpu_burst(task, cpu_id);
+            task->last_cpu = cpu_id;
+            auto busy_start = chrono::steady_clock::now();
+            // coroutine mode: expires from CoroRuntime's wheel; thread mode: busy-waits
+            co_await sleep_for(duration);
+            counters.busy_us += elapsed_us(busy_start, chrono::steady_clock::now());
+            task->bursts.pop_front();
+            if (slot){
+                slot->store(counters);
+                last_publish = chrono::steady_clock::now();
+            }
+
+            if (task->bursts.empty()){
+                logger.write("CPU", cpu_id, task, "FINISH_CPU", to_string(duration));
+                sched->finish_task(cpu_id, task);
+                delete task;
+                continue;
+            }
+            run = true;
+            //logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU", to_string(duration));
+        }
+        // Finish CPU burst
+        if (run)
+            logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU", to_string(duration));
+        else
+            logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU");
+        // look at next job
+        job_type = task->bursts.front();
+        device_id = job_type.first;
+        duration = job_type.second;
+
+        if (device_id >= IO_ID_OFFSET){
+            int io_id = (device_id - IO_ID_OFFSET) % config.num_io;
+            io_mutex[io_id].lock();
+            io_queue[io_id].push({cpu_id, task});
+            io_mutex[io_id].unlock();
+        } else {
+            // more cpu time - return to scheduler
+            logger.write("CPU", cpu_id, task, "ENTER_SCHED");
+            sched->return_task(cpu_id, task);
+        }
+
+    }
+    cpu_state[cpu_id].store(false);
+    if (slot) slot->store(counters);
+}
+
+// -------------------- thread mode --------------------
+void *Simulation::IO_thread(void *arg){
+    pair<Simulation*, int> *param = (pair<Simulation*, int>*)arg;
+    Simulation *sim = param->first;
+    int io_id = param->second;
+    // IOs sit on the cores after the CPUs (4,5,... for up to 4 CPUs)
+    set_realtime_and_affinity(max(sim->config.num_cpu, IO_ID_OFFSET) + io_id, max(1, 76-io_id));
+    sim->IO_device(io_id).run_inline();
+    pthread_exit(nullptr);
+    return nullptr;
+}
+
+void *Simulation::processor_thread(void *arg){
+    pair<Simulation*, int> *param = (pair<Simulation*, int>*)arg;
+    Simulation *sim = param->first;
+    int cpu_id = param->second;
+    set_realtime_and_affinity(cpu_id, max(1, 80-cpu_id));
+    sim->processor(cpu_id).run_inline();
+    pthread_exit(nullptr);
+    return nullptr;
+}
+
+void Simulation::run_threads(){
+    int num_cpu = config.num_cpu, num_io = config.num_io;
+
+    // create IO threads
+    vector<pthread_t> io_threads(num_io);
+    vector<pair<Simulation*, int>> io_params(num_io);
+    for (int i = 0; i < num_io; ++i){
+        io_params[i] = pair<Simulation*, int>(this, i);
+        int ret = pthread_create(&io_threads[i], nullptr, IO_thread, &io_params[i]);
+        if (ret != 0){
+            cerr << "pthread_create error: IO\n";
+            exit(1);
+        }
+    }
+
+    // create CPU threads
+    vector<pthread_t> cpu_threads(num_cpu);
+    vector<pair<Simulation*, int>> cpu_params(num_cpu);
+    for (int i = 0; i < num_cpu; ++i){
+        cpu_params[i] = pair<Simulation*, int>(this, i);
+        int ret = pthread_create(&cpu_threads[i], nullptr, processor_thread, &cpu_params[i]);
+        if (ret != 0){
+            cerr << "pthread_create error: CPU\n";
+            exit(1);
+        }
+    }
+
+    // join IO threads
+    for (int i = 0; i < num_io; ++i){
+        pthread_join(io_threads[i], NULL);
+    }
+
+    // join CPU threads
+    for (int i = 0; i < num_cpu; ++i){
+        pthread_join(cpu_threads[i], NULL);
+    }
+}
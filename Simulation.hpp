@@ -0,0 +1,82 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include "Scheduler.hpp"
+#include "Stats.hpp"
+#include "CoroRuntime.hpp"
+#include "Metrics.hpp"
+
+// one run of the emulator: NUM_CPU processors and NUM_IO devices sharing a
+// scheduler. everything a run touches lives in here, so several runs can be
+// set up one after the other (or side by side) in the same process.
+
+struct SimConfig {
+    std::string trace;
+    std::string algo;        // On / O1 / EDF
+    int num_cpu;
+    int num_io;
+    int io_depth;            // requests a device serves concurrently
+    Workload workload;
+    int coro_workers;        // 0: thread mode
+    bool logging;            // cpu*.log / io*.log
+    bool stats;              // publish live counters for schedtop
+
+    SimConfig();
+};
+
+struct SimResult {
+    MetricsSummary metrics;
+    // per cpu: time spent in request_task and number of calls (idle polls included)
+    std::vector<long long> sched_ns;
+    std::vector<long long> sched_calls;
+};
+
+const int MAX_NUM_CPU = 256;
+const int MAX_NUM_IO = 64;
+
+// nullptr if algo is not On / O1 / EDF
+Scheduler *make_scheduler(const std::string &algo, const std::string &filename,
+                          int num_cpu, const Workload &workload);
+
+class Simulation {
+    SimConfig config;
+    Scheduler *sched;
+    std::chrono::steady_clock::time_point start_time;
+
+    std::atomic<bool> *cpu_state;
+    std::queue<Task*> *tasks_return_from_io;
+    std::mutex *ret_mutex;
+    std::queue<std::pair<int, Task*>> *io_queue;
+    std::mutex *io_mutex;
+    std::atomic<bool> *io_running;
+    std::atomic<bool> shut_down;
+
+    MetricsAccumulator *cpu_metrics;        // one per cpu, merged after the run
+    long long *sched_ns, *sched_calls;      // one per cpu
+    // live counters for schedtop, each slot has exactly one writer thread
+    StatsSegment stats;
+
+public:
+    // throws runtime_error if the trace cannot be opened or algo is unknown
+    Simulation(const SimConfig &config);
+    ~Simulation();
+    // runs the whole trace, once
+    SimResult run();
+
+private:
+    Job IO_device(int io_id);
+    Job processor(int cpu_id);
+    // thread mode: one pinned SCHED_FIFO pthread per emulated device
+    void run_threads();
+    static void *IO_thread(void *arg);
+    static void *processor_thread(void *arg);
+};
+
+#endif
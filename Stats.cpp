@@ -0,0 +1,128 @@
+#include "Stats.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <new>
+
+int latency_bucket(uint64_t ns){
+    int b = 0;
+    ns >>= 7;
+    while (ns && b < STATS_LATENCY_BUCKETS - 1){
+        ns >>= 1;
+        b += 1;
+    }
+    return b;
+}
+
+StatsSegment::StatsSegment()
+    : base(nullptr), length(0), owner(false)
+    {}
+
+StatsSegment::~StatsSegment(){
+    if (owner && valid())
+        header()->running.store(0, std::memory_order_release);
+    detach();
+}
+
+size_t StatsSegment::segment_size(int num_cpu, int num_io){
+    return sizeof(StatsHeader)
+         + sizeof(SeqSlot<CpuCounters>) * num_cpu
+         + sizeof(SeqSlot<IoCounters>) * num_io;
+}
+
+bool StatsSegment::create(int num_cpu, int num_io){
+    detach();
+    // start from a fresh segment so a viewer attached to an old run notices
+    shm_unlink(STATS_SHM_NAME);
+    int fd = shm_open(STATS_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0){
+        std::cerr << "Failed to create stats segment: " << strerror(errno) << std::endl;
+        return false;
+    }
+    size_t len = segment_size(num_cpu, num_io);
+    if (ftruncate(fd, len) != 0){
+        std::cerr << "Failed to size stats segment: " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED){
+        std::cerr << "Failed to map stats segment: " << strerror(errno) << std::endl;
+        return false;
+    }
+    base = p;
+    length = len;
+    owner = true;
+
+    // ftruncate zero-fills, so every counter and sequence number starts at 0
+    StatsHeader *h = new (base) StatsHeader;
+    h->version = STATS_VERSION;
+    h->num_cpu = num_cpu;
+    h->num_io = num_io;
+    h->pid = getpid();
+    h->running.store(1, std::memory_order_relaxed);
+    for (int i = 0; i < num_cpu; ++i) new (cpu(i)) SeqSlot<CpuCounters>;
+    for (int i = 0; i < num_io; ++i) new (io(i)) SeqSlot<IoCounters>;
+    // magic last: viewers ignore the segment until it is fully laid out
+    std::atomic_thread_fence(std::memory_order_release);
+    h->magic = STATS_MAGIC;
+    return true;
+}
+
+bool StatsSegment::attach(){
+    detach();
+    int fd = shm_open(STATS_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(StatsHeader)){
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+    base = p;
+    length = st.st_size;
+    owner = false;
+
+    StatsHeader *h = header();
+    if (h->magic != STATS_MAGIC || h->version != STATS_VERSION
+        || segment_size(h->num_cpu, h->num_io) > length){
+        detach();
+        return false;
+    }
+    return true;
+}
+
+void StatsSegment::detach(){
+    if (base) munmap(base, length);
+    base = nullptr;
+    length = 0;
+}
+
+bool StatsSegment::valid() const {
+    return base != nullptr;
+}
+
+StatsHeader *StatsSegment::header() const {
+    return (StatsHeader*)base;
+}
+
+SeqSlot<CpuCounters> *StatsSegment::cpu(int cpu_id) const {
+    if (!base) return nullptr;
+    char *p = (char*)base + sizeof(StatsHeader);
+    return (SeqSlot<CpuCounters>*)p + cpu_id;
+}
+
+SeqSlot<IoCounters> *StatsSegment::io(int io_id) const {
+    if (!base) return nullptr;
+    char *p = (char*)base + sizeof(StatsHeader)
+            + sizeof(SeqSlot<CpuCounters>) * header()->num_cpu;
+    return (SeqSlot<IoCounters>*)p + io_id;
+}
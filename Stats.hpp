@@ -0,0 +1,110 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// shared memory segment for live monitoring (see schedtop.cpp)
+// layout: StatsHeader | SeqSlot<CpuCounters>[num_cpu] | SeqSlot<IoCounters>[num_io]
+
+#define STATS_SHM_NAME "/os_sched_stats"
+const uint32_t STATS_MAGIC = 0x53434854;   // "SCHT"
+const uint32_t STATS_VERSION = 2;
+
+// pick latency histogram: bucket b counts request_task calls taking
+// [2^(b+6), 2^(b+7)) ns, bucket 0 also holds everything below 128ns
+const int STATS_LATENCY_BUCKETS = 16;
+
+struct CpuCounters {
+    uint64_t dispatched;
+    uint64_t runqueue_len;
+    uint64_t busy_us;
+    uint64_t idle_us;
+    uint64_t pick_latency[STATS_LATENCY_BUCKETS];
+};
+
+struct IoCounters {
+    uint64_t served;
+    uint64_t queue_depth;
+    uint64_t in_flight;
+    uint64_t busy_us;
+    uint64_t idle_us;
+};
+
+int latency_bucket(uint64_t ns);
+
+// seqlock protected copy of T, exactly one writer per slot, writer never blocks
+template <typename T>
+struct alignas(64) SeqSlot {
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "counters must be made of uint64_t");
+    static const size_t N = sizeof(T) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> data[N];
+
+    void store(const T &value){
+        uint64_t words[N];
+        std::memcpy(words, &value, sizeof(T));
+        uint64_t s = seq.load(std::memory_order_relaxed);
+        seq.store(s + 1, std::memory_order_relaxed);   // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < N; ++i)
+            data[i].store(words[i], std::memory_order_relaxed);
+        seq.store(s + 2, std::memory_order_release);
+    }
+
+    // returns false if the writer kept the slot busy for every attempt
+    bool load(T &out, int max_retry = 1000) const {
+        uint64_t words[N];
+        for (int attempt = 0; attempt < max_retry; ++attempt){
+            uint64_t s1 = seq.load(std::memory_order_acquire);
+            if (s1 & 1) continue;
+            for (size_t i = 0; i < N; ++i)
+                words[i] = data[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == s1){
+                std::memcpy(&out, words, sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct alignas(64) StatsHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t num_cpu;
+    uint32_t num_io;
+    std::atomic<uint32_t> running;
+    int32_t pid;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs lock-free 64-bit atomics");
+
+class StatsSegment {
+    void *base;
+    size_t length;
+    bool owner;
+
+public:
+    StatsSegment();
+    ~StatsSegment();
+    // simulator side: (re)create the segment, read-write
+    bool create(int num_cpu, int num_io);
+    // viewer side: map an existing segment read-only
+    bool attach();
+    void detach();
+    bool valid() const;
+
+    StatsHeader *header() const;
+    SeqSlot<CpuCounters> *cpu(int cpu_id) const;
+    SeqSlot<IoCounters> *io(int io_id) const;
+
+private:
+    static size_t segment_size(int num_cpu, int num_io);
+};
+
+#endif
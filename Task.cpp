@@ -1,6 +1,39 @@
 #include "Task.hpp"
+#include <sstream>
 
 Task::Task(int task_id, int rt_priority, int nice, int policy, std::vector<std::pair<int, int>> bursts, int affinity) 
     : task_id(task_id), rt_priority(rt_priority), nice(nice), policy(policy)
-    , bursts(bursts), cpu_affinity(affinity) {}
+    , bursts(bursts.begin(), bursts.end()), cpu_affinity(affinity), last_cpu(-1), deadline(-1), period(-1), abs_deadline(-1)
+    , first_sched(-1), last_sched(-1), first_cpu(-1), waiting(0) {}
 
+int Task::cpu_time() const {
+    int total = 0;
+    for (auto &burst : bursts){
+        if (burst.first < IO_ID_OFFSET) total += burst.second;
+    }
+    return total;
+}
+
+Task *parse_task(const std::string &line){
+    std::istringstream iss(line);
+    int task_id, rt_priority, nice, policy;
+    iss >> task_id >> rt_priority >> nice >> policy;
+
+    std::vector<std::pair<int, int>> bursts;
+    int device_id, duration;
+    while (iss >> device_id >> duration){
+        bursts.push_back(std::pair<int, int>(device_id, duration));
+    }
+    Task *task = new Task(task_id, rt_priority, nice, policy, bursts);
+
+    // optional trailing fields, absent in the original trace format
+    iss.clear();
+    std::string key;
+    int value;
+    while (iss >> key >> value){
+        if (key == "d") task->deadline = value;
+        else if (key == "p") task->period = value;
+        else if (key == "a") task->cpu_affinity = value;
+    }
+    return task;
+}
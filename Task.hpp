@@ -2,17 +2,33 @@
 #define TASK_HPP
 
 #include <vector>
+#include <deque>
 #include <utility>
+#include <string>
+
+const int IO_ID_OFFSET = 4;      // device ids for IO start here (4,5,...)
 
 struct Task {
     int task_id;
     int rt_priority;
     int nice;
     int policy;
-    std::vector<std::pair<int, int>> bursts;
-    int cpu_affinity;
+    std::deque<std::pair<int, int>> bursts;   // front is the next burst, consumed with pop_front
+    int cpu_affinity;        // hard affinity, only this cpu may run the task, -1 if none
+    int last_cpu;            // cpu that ran the previous CPU burst, -1 before the first
+    int deadline;            // relative to arrival in us, -1 if none
+    int period;              // us, -1 if none
+    long long abs_deadline;  // us since start, set on arrival, -1 if none
+    // filled in by MetricsAccumulator, us since start
+    long long first_sched, last_sched, first_cpu, waiting;
 
     Task(int task_id, int rt_priority, int nice, int policy, std::vector<std::pair<int, int>> bursts, int affinity=-1);
+    // sum of the CPU burst durations
+    int cpu_time() const;
 };
 
+// parse one line of a task file:
+// <task_id> <rt_priority> <nice> <policy> <device_id> <duration> ... [d <deadline>] [p <period>] [a <cpu>]
+Task *parse_task(const std::string &line);
+
 #endif
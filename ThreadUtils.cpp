@@ -2,6 +2,7 @@
 #include <sched.h>
 #include <iostream>
 #include <cstring>
+#include <chrono>
 
 bool set_realtime_and_affinity(int id, int priority) {
     pthread_t this_thread = pthread_self();
@@ -38,3 +39,12 @@ bool set_realtime_and_affinity(int id, int priority) {
 
     return true;
 }
+
+void busy_sleep_microseconds(int duration_us) {
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::microseconds(duration_us);
+
+    while (std::chrono::steady_clock::now() < end) {
+        // busy wait
+    }
+}
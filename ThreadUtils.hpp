@@ -6,4 +6,7 @@
 // Returns true if successfully pinned and set to SCHED_FIFO
 bool set_realtime_and_affinity(int cpu_id, int priority = 80);
 
+// spin on steady_clock, emulates a device being busy for duration_us
+void busy_sleep_microseconds(int duration_us);
+
 #endif // THREAD_UTILS_HPP
@@ -0,0 +1,149 @@
+#include "TimerWheel.hpp"
+
+TimerNode::TimerNode()
+    : expires(0), prev(nullptr), next(nullptr), level(-1), slot(-1), data(nullptr)
+    {}
+
+bool TimerNode::pending() const {
+    return level >= 0;
+}
+
+TimerWheel::TimerWheel(uint64_t now)
+    : next_tick(now + 1), pending(0)
+{
+    for (int l = 0; l < LEVELS; ++l){
+        occupied[l] = 0;
+        for (int s = 0; s < SLOTS; ++s) slots[l][s] = nullptr;
+    }
+}
+
+// pick the level from the distance to next_tick, the slot from the expiry itself
+void TimerWheel::link(TimerNode *node){
+    if (node->expires < next_tick) node->expires = next_tick;
+    uint64_t delta = node->expires - next_tick;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= ((uint64_t)1 << (LEVEL_BITS * (level + 1))))
+        level += 1;
+    uint64_t max_delta = ((uint64_t)1 << (LEVEL_BITS * LEVELS)) - 1;
+    if (delta > max_delta) node->expires = next_tick + max_delta;
+    int slot = (node->expires >> (LEVEL_BITS * level)) & (SLOTS - 1);
+
+    node->level = level;
+    node->slot = slot;
+    node->prev = nullptr;
+    node->next = slots[level][slot];
+    if (node->next) node->next->prev = node;
+    slots[level][slot] = node;
+    occupied[level] |= (uint64_t)1 << slot;
+}
+
+void TimerWheel::unlink(TimerNode *node){
+    if (node->prev) node->prev->next = node->next;
+    else slots[node->level][node->slot] = node->next;
+    if (node->next) node->next->prev = node->prev;
+    if (!slots[node->level][node->slot])
+        occupied[node->level] &= ~((uint64_t)1 << node->slot);
+    node->prev = node->next = nullptr;
+    node->level = node->slot = -1;
+}
+
+void TimerWheel::insert(TimerNode *node, uint64_t expires){
+    if (node->pending()) cancel(node);
+    node->expires = expires;
+    link(node);
+    pending += 1;
+}
+
+void TimerWheel::cancel(TimerNode *node){
+    if (!node->pending()) return;
+    unlink(node);
+    pending -= 1;
+}
+
+// re-file the slot of `level` that covers next_tick into lower levels
+void TimerWheel::cascade(int level){
+    int slot = (next_tick >> (LEVEL_BITS * level)) & (SLOTS - 1);
+    TimerNode *node = slots[level][slot];
+    slots[level][slot] = nullptr;
+    occupied[level] &= ~((uint64_t)1 << slot);
+    while (node){
+        TimerNode *next = node->next;
+        link(node);
+        node = next;
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<TimerNode*> &expired){
+    while (next_tick <= now){
+        if (pending == 0){
+            next_tick = now + 1;
+            break;
+        }
+        int idx = next_tick & (SLOTS - 1);
+        if (idx == 0){
+            // entering a new level 0 block: pull the matching slots down
+            for (int l = 1; l < LEVELS; ++l){
+                cascade(l);
+                if ((next_tick >> (LEVEL_BITS * l)) & (SLOTS - 1)) break;
+            }
+        }
+        // nothing left in this level 0 block: jump to its end
+        uint64_t ahead = occupied[0] >> idx;
+        if (ahead == 0){
+            uint64_t block_end = (next_tick | (SLOTS - 1)) + 1;
+            next_tick = (block_end <= now + 1) ? block_end : now + 1;
+            continue;
+        }
+        int skip = __builtin_ctzll(ahead);
+        if (next_tick + skip > now){
+            next_tick = now + 1;
+            break;
+        }
+        next_tick += skip;
+        idx += skip;
+
+        TimerNode *node = slots[0][idx];
+        slots[0][idx] = nullptr;
+        occupied[0] &= ~((uint64_t)1 << idx);
+        while (node){
+            TimerNode *next = node->next;
+            node->prev = node->next = nullptr;
+            node->level = node->slot = -1;
+            expired.push_back(node);
+            pending -= 1;
+            node = next;
+        }
+        next_tick += 1;
+    }
+}
+
+// level 0 slots hold a single expiry each. above that, the first occupied
+// slot from the current one on holds the level's earliest timers. the current
+// slot only counts while next_tick sits on its boundary and it has not been
+// cascaded yet; after that it only holds timers a full turn ahead.
+// a slot's list is only scanned if its range could beat what lower levels
+// already found, so a busy wheel rarely walks more than level 0.
+uint64_t TimerWheel::next_expiry() const {
+    uint64_t best = UINT64_MAX;
+    for (int l = 0; l < LEVELS; ++l){
+        if (!occupied[l]) continue;
+        int shift = LEVEL_BITS * l;
+        int cur = (next_tick >> shift) & (SLOTS - 1);
+        int offset = (next_tick & (((uint64_t)1 << shift) - 1)) ? 1 : 0;
+        int start = (cur + offset) & (SLOTS - 1);
+        // rotate so bit 0 is the first slot to come up
+        uint64_t ahead = (occupied[l] >> start) | (start ? occupied[l] << (SLOTS - start) : 0);
+        int skip = __builtin_ctzll(ahead);
+        uint64_t range_start = ((next_tick >> shift) + offset + skip) << shift;
+        if (range_start >= best) continue;
+        int slot = (start + skip) & (SLOTS - 1);
+        for (TimerNode *node = slots[l][slot]; node; node = node->next)
+            if (node->expires < best) best = node->expires;
+    }
+    return best;
+}
+
+size_t TimerWheel::size() const {
+    return pending;
+}
@@ -0,0 +1,51 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// intrusive timer, owned by the caller and linked into at most one wheel
+struct TimerNode {
+    uint64_t expires;
+    TimerNode *prev;
+    TimerNode *next;
+    int level;          // -1 when not pending
+    int slot;
+    void *data;         // free for the owner
+
+    TimerNode();
+    bool pending() const;
+};
+
+// hierarchical timing wheel (linux timer_list style), one tick = 1us.
+// level L has 64 slots of 64^L ticks each; a timer sits in the lowest level
+// whose range covers it and is cascaded down when its slot comes up.
+// insert and cancel are O(1), advance expires all due timers in one batch.
+class TimerWheel {
+public:
+    static const int LEVEL_BITS = 6;
+    static const int SLOTS = 1 << LEVEL_BITS;
+    static const int LEVELS = 6;     // 2^36 us, about 19 hours
+
+    explicit TimerWheel(uint64_t now = 0);
+    void insert(TimerNode *node, uint64_t expires);
+    void cancel(TimerNode *node);
+    // appends every timer with expires <= now to expired, they are no longer pending
+    void advance(uint64_t now, std::vector<TimerNode*> &expired);
+    // earliest expires among pending timers, UINT64_MAX if there are none
+    uint64_t next_expiry() const;
+    size_t size() const;
+
+private:
+    TimerNode *slots[LEVELS][SLOTS];
+    uint64_t occupied[LEVELS];   // bit s set if slots[level][s] is non-empty
+    uint64_t next_tick;          // first tick not processed yet
+    size_t pending;
+
+    void link(TimerNode *node);
+    void unlink(TimerNode *node);
+    void cascade(int level);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <list>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include "GoodnessKernel.hpp"
+
+using namespace std;
+
+// compares the original std::list scan of Scheduler_On with the SoA kernels
+// ./bench_goodness
+
+// the pre-SoA selection loop, kept here as the reference
+static Task *list_pick(const list<Task*> &ready_queue, int cpu_id){
+    pair<int, Task*> best_choice(-2000, nullptr);
+    for (Task *task: ready_queue){
+        int good_val = goodness(cpu_id, task->policy, task->rt_priority, task->nice,
+                                task->bursts.front().first, task->bursts.front().second,
+                                task->cpu_affinity, task->last_cpu);
+        if (good_val > best_choice.first){
+            best_choice.first = good_val;
+            best_choice.second = task;
+        }
+    }
+    return best_choice.second;
+}
+
+// same task mix as taskGenerater.py, RT tasks are rare so the
+// SCHED_OTHER branch is what usually decides; some tasks are pinned and
+// most have already run somewhere
+static Task *random_task(int id, mt19937 &rng){
+    uniform_int_distribution<int> kind(0, 99), rt(80, 99), nice(-20, 19),
+                                  dev(0, 5), dur(10, 400), cpu(-1, 3);
+    int policy = (kind(rng) < 2) ? 1 + kind(rng) % 2 : 0;
+    vector<pair<int, int>> bursts{{dev(rng), dur(rng)}};
+    int affinity = (kind(rng) < 10) ? cpu(rng) : -1;
+    Task *task = new Task(id, policy ? rt(rng) : 0, policy ? 0 : nice(rng), policy, bursts, affinity);
+    task->last_cpu = cpu(rng);
+    return task;
+}
+
+template <typename F>
+static double time_ns(F f, int rounds){
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) f(r);
+    auto finish = chrono::steady_clock::now();
+    return chrono::duration_cast<chrono::nanoseconds>(finish - start).count() / (double)rounds;
+}
+
+int main(){
+    mt19937 rng(777);
+    volatile int sink = 0;
+    bool ok = true;
+    cout << "dispatch kernel: " << goodness_kernel_name() << "\n";
+    cout << setw(8) << "tasks" << setw(12) << "list ns" << setw(12) << "scalar ns"
+         << setw(12) << "sse2 ns" << setw(12) << "avx2 ns" << setw(10) << "speedup" << "\n";
+
+    for (int n : {1000, 10000, 100000}){
+        list<Task*> lst;
+        ReadyQueueSoA rq;
+        for (int i = 0; i < n; ++i){
+            Task *t = random_task(i, rng);
+            lst.push_back(t);
+            rq.push_back(t);
+        }
+
+        // every kernel must agree with the list scan, on every cpu id
+        for (int cpu = 0; cpu < 4; ++cpu){
+            Task *expect = list_pick(lst, cpu);
+            if (rq.tasks[goodness_argmax_scalar(rq, cpu)] != expect
+                || rq.tasks[goodness_argmax_sse2(rq, cpu)] != expect
+                || rq.tasks[goodness_argmax_avx2(rq, cpu)] != expect
+                || rq.tasks[goodness_argmax(rq, cpu)] != expect){
+                cerr << "mismatch at n=" << n << " cpu=" << cpu << "\n";
+                ok = false;
+            }
+        }
+
+        int rounds = max(20, 2000000 / n);
+        double t_list = time_ns([&](int r){ sink = sink + list_pick(lst, r & 3)->task_id; }, rounds);
+        double t_scalar = time_ns([&](int r){ sink = sink + goodness_argmax_scalar(rq, r & 3); }, rounds);
+        double t_sse2 = time_ns([&](int r){ sink = sink + goodness_argmax_sse2(rq, r & 3); }, rounds);
+        double t_avx2 = time_ns([&](int r){ sink = sink + goodness_argmax_avx2(rq, r & 3); }, rounds);
+        double t_best = time_ns([&](int r){ sink = sink + goodness_argmax(rq, r & 3); }, rounds);
+
+        cout << setw(8) << n << fixed << setprecision(0)
+             << setw(12) << t_list << setw(12) << t_scalar
+             << setw(12) << t_sse2 << setw(12) << t_avx2
+             << setw(9) << setprecision(1) << t_list / t_best << "x\n";
+
+        for (Task *t : lst) delete t;
+    }
+    return ok ? 0 : 1;
+}
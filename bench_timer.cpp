@@ -0,0 +1,131 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <queue>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include "TimerWheel.hpp"
+
+using namespace std;
+
+// TimerWheel vs std::priority_queue with N pending timers
+// ./bench_timer
+//
+// each round: insert N timers due within 1s, cancel 10% of them, then
+// advance time in 50us steps until everything expired (the way IO_device
+// and CoroRuntime poll). priority_queue cancels lazily with a tombstone.
+
+static double ms_since(chrono::steady_clock::time_point t){
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - t).count() / 1000.0;
+}
+
+int main(){
+    const uint64_t HORIZON_US = 1000000;
+    const uint64_t STEP_US = 50;
+    bool ok = true;
+
+    cout << setw(9) << "timers" << setw(12) << "" << setw(11) << "insert ms"
+         << setw(11) << "cancel ms" << setw(11) << "expire ms" << setw(11) << "total ms" << "\n";
+
+    for (int n : {10000, 100000, 1000000}){
+        mt19937_64 rng(777);
+        uniform_int_distribution<uint64_t> due(1, HORIZON_US);
+        vector<uint64_t> expires(n);
+        for (auto &e : expires) e = due(rng);
+        vector<int> to_cancel(n / 10);
+        for (auto &c : to_cancel) c = rng() % n;
+        sort(to_cancel.begin(), to_cancel.end());
+        to_cancel.erase(unique(to_cancel.begin(), to_cancel.end()), to_cancel.end());
+
+        // -------- TimerWheel --------
+        vector<TimerNode> nodes(n);
+        TimerWheel wheel(0);
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) wheel.insert(&nodes[i], expires[i]);
+        double w_insert = ms_since(t0);
+
+        t0 = chrono::steady_clock::now();
+        for (int i : to_cancel) wheel.cancel(&nodes[i]);
+        double w_cancel = ms_since(t0);
+
+        size_t w_expired = 0;
+        uint64_t w_checksum = 0;
+        vector<TimerNode*> batch;
+        t0 = chrono::steady_clock::now();
+        for (uint64_t now = 0; now <= HORIZON_US; now += STEP_US){
+            wheel.advance(now, batch);
+            for (TimerNode *node : batch){
+                // due in (now - STEP_US, now]: never early, never a step late
+                if (node->expires > now || node->expires + STEP_US <= now) ok = false;
+                w_checksum += node - nodes.data();
+            }
+            w_expired += batch.size();
+            batch.clear();
+        }
+        double w_expire = ms_since(t0);
+
+        // next_expiry, untimed: after every step it must equal the earliest
+        // expiry still pending
+        vector<uint64_t> remaining;
+        vector<char> dropped(n, 0);
+        for (int i : to_cancel) dropped[i] = 1;
+        for (int i = 0; i < n; ++i)
+            if (!dropped[i]) remaining.push_back(expires[i]);
+        sort(remaining.begin(), remaining.end());
+        TimerWheel check(0);
+        for (int i = 0; i < n; ++i) check.insert(&nodes[i], expires[i]);
+        for (int i : to_cancel) check.cancel(&nodes[i]);
+        size_t next = 0;
+        for (uint64_t now = 0; now <= HORIZON_US; now += STEP_US){
+            check.advance(now, batch);
+            batch.clear();
+            while (next < remaining.size() && remaining[next] <= now) next += 1;
+            uint64_t expect = next < remaining.size() ? remaining[next] : UINT64_MAX;
+            if (check.next_expiry() != expect){
+                cerr << "next_expiry mismatch at n=" << n << " now=" << now << "\n";
+                ok = false;
+                break;
+            }
+        }
+
+        // -------- priority_queue --------
+        typedef pair<uint64_t, int> Entry;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> pq;
+        vector<char> cancelled(n, 0);
+        t0 = chrono::steady_clock::now();
+        for (int i = 0; i < n; ++i) pq.push(Entry(expires[i], i));
+        double q_insert = ms_since(t0);
+
+        t0 = chrono::steady_clock::now();
+        for (int i : to_cancel) cancelled[i] = 1;
+        double q_cancel = ms_since(t0);
+
+        size_t q_expired = 0;
+        uint64_t q_checksum = 0;
+        t0 = chrono::steady_clock::now();
+        for (uint64_t now = 0; now <= HORIZON_US; now += STEP_US){
+            while (!pq.empty() && pq.top().first <= now){
+                int i = pq.top().second;
+                pq.pop();
+                if (cancelled[i]) continue;
+                q_checksum += i;
+                q_expired += 1;
+            }
+        }
+        double q_expire = ms_since(t0);
+
+        if (w_expired != q_expired || w_checksum != q_checksum || wheel.size() != 0){
+            cerr << "mismatch at n=" << n << "\n";
+            ok = false;
+        }
+
+        cout << fixed << setprecision(2)
+             << setw(9) << n << setw(12) << "wheel" << setw(11) << w_insert << setw(11) << w_cancel
+             << setw(11) << w_expire << setw(11) << w_insert + w_cancel + w_expire << "\n"
+             << setw(9) << "" << setw(12) << "prio_queue" << setw(11) << q_insert << setw(11) << q_cancel
+             << setw(11) << q_expire << setw(11) << q_insert + q_cancel + q_expire << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -1,365 +1,78 @@
 #include <iostream>
-#include <pthread.h>
-#include <queue>
-#include <unistd.h>
-#include <chrono>
 #include <stdexcept>
 #include <vector>
-#include <atomic>
-#include <mutex>
 #include <string>
-#include "Scheduler_On.hpp"
-#include "Scheduler_O1.hpp"
-#include "ThreadUtils.hpp"
+#include "Simulation.hpp"
 
 using namespace std;
 
-chrono::steady_clock::time_point global_start_time;
-
-// -------------------- configuration --------------------
-int workload_factor1;
-int workload_factor2;
-
-int NUM_CPU = 0;
-const int MAX_NUM_CPU = 4;
-atomic<bool> cpu_state[MAX_NUM_CPU];
-queue<Task*> tasks_return_from_io[MAX_NUM_CPU];
-
-const int NUM_IO = 2;
-const int IO_ID_OFFSET = 4;      // device ids for IO start here (4,5,...)
-queue<pair<int, Task*>> io_queue[NUM_IO];
-
-//mutex mutexes[NUM_DEVICES];
-mutex cerr_mutex;
-mutex io_mutex[NUM_IO];
-mutex ret_mutex[4];
-atomic<bool> io_running[NUM_IO];
-atomic<bool> shut_down(false);
-
-void busy_sleep_microseconds(int duration_us);
-
-// small safe print function to avoid interleaved cerr
-void safe_cerr(const string &s){
-    cerr_mutex.lock();
-    cerr << s << flush;
-    cerr_mutex.unlock();
-}
-
-// -------------------- I/O device thread --------------------
-void *IO_device(void *arg){
-    int device_id = *((int*)arg);
-    int io_id = device_id - IO_ID_OFFSET;
-    //safe_cerr("Turn on I/O #" + to_string(io_id) + "\n");
-    set_realtime_and_affinity(io_id+IO_ID_OFFSET, 76-io_id);
-    // init Logger
-    Logger logger("io" + to_string(io_id) + ".log", global_start_time);
-    // let the file be opened before running time
-    logger.write("IO", io_id, -1, "INIT");
-    busy_sleep_microseconds(10000);
-
-    while (true){
-        // lock this device's mutex and pop a task if present
-        io_mutex[io_id].lock();
-        bool has_task = !io_queue[io_id].empty();
-        if (has_task){
-            io_running[io_id].store(true);
-            auto temp = io_queue[io_id].front();
-            io_queue[io_id].pop();
-            io_mutex[io_id].unlock();
-
-            int cpu_id = temp.first;
-            Task *task = temp.second;
-            if (!task){
-                safe_cerr("IO_device: null task pointer!\n");
-                continue;
-            }
-
-            if (task->bursts.empty()){
-                throw runtime_error("no task duration time in IO_device");
-            }
-
-            
-            auto job_type = task->bursts.front();
-            int duration = job_type.second;
-            logger.write("IO", io_id, task->task_id, "ENTER_IO");
-            if (duration <= 0) throw runtime_error("duration time error in IO_device");
-            busy_sleep_microseconds(duration);
-            task->bursts.pop_back();
-            logger.write("IO", io_id, task->task_id, "LEAVE_IO");//, to_string(duration));
-
-            // return to CPU queue: lock that cpu's queue mutex
-            if (cpu_id < 0 || cpu_id >= NUM_CPU){
-                safe_cerr("IO_device: invalid cpu_id returned: " + to_string(cpu_id) + "\n");
-                continue;
-            }
-            ret_mutex[cpu_id].lock();
-            tasks_return_from_io[cpu_id].push(task);
-            ret_mutex[cpu_id].unlock();
-        } else {
-            io_mutex[io_id].unlock();
-            io_running[io_id].store(false);
-
-            // check shutdown condition: 
-            bool all_not_running = true;
-            for (int i = 0; i < NUM_CPU; ++i){
-                all_not_running &= !cpu_state[i].load();
-            }
-            if (all_not_running){
-                shut_down.store(true);
-                //safe_cerr("Shut down I/O #" + to_string(io_id) + "\n");
-                break;
-            }
-        }
-    }
-
-    pthread_exit(nullptr);
-    return nullptr;
-}
-
-// -------------------- CPU thread --------------------
-void *processor(void *arg){
-    pair<int*, Scheduler*> *cpu_param = (pair<int*, Scheduler*>*)arg;
-    int cpu_id = *cpu_param->first;
-    Scheduler *sched = cpu_param->second;
-    //safe_cerr("Turn on CPU #" + to_string(cpu_id) + "\n");
-
-    set_realtime_and_affinity(cpu_id, 80-cpu_id);
-    // init Logger
-    Logger logger("cpu" + to_string(cpu_id) + ".log", global_start_time);
-    logger.write("CPU", cpu_id, -1, "INIT");
-    busy_sleep_microseconds(10000);
-
-    std::chrono::microseconds total_elapsed{0};
-    int count = 0;
-    cpu_state[cpu_id].store(true);
-    // preload n tasks to create a stable workload
-    sched->read_next_n_tasks(workload_factor1, cpu_id, logger);
-
-    while (true){
-        // drain returned tasks safely under lock
-        ret_mutex[cpu_id].lock();
-        while (!tasks_return_from_io[cpu_id].empty()){
-            Task *ret_task = tasks_return_from_io[cpu_id].front();
-            tasks_return_from_io[cpu_id].pop();
-            ret_mutex[cpu_id].unlock();
-
-            if (!ret_task){
-                safe_cerr("processor: null ret_task\n");
-            } else if (!(ret_task->bursts.empty())){
-                sched->return_task(cpu_id, ret_task);
-                logger.write("CPU", cpu_id, ret_task->task_id, "ENTER_SCHED");
-            } else {
-                // end of task
-                logger.write("CPU", cpu_id, ret_task->task_id, "FINISH_IO");
-                delete ret_task;
-            }
-
-            ret_mutex[cpu_id].lock();
-        }
-        ret_mutex[cpu_id].unlock();
-
-        // request a task from scheduler
-        auto start = chrono::steady_clock::now();
-        Task *task = sched->request_task(cpu_id, logger);
-        auto finish = chrono::steady_clock::now();
-        total_elapsed += std::chrono::duration_cast<std::chrono::microseconds>(finish - start);
-        count += 1;
-        if (!task){
-
-            // check IO queues and returned task queues under proper locks
-            bool all_io_empty = true;
-            for (int i = 0; i < NUM_IO; ++i){
-                io_mutex[i].lock();
-                all_io_empty &= io_queue[i].empty();
-                io_mutex[i].unlock();
-            }
-
-            bool all_ret_empty = true;
-            for (int i = 0; i < NUM_CPU; ++i){
-                ret_mutex[i].lock();
-                all_ret_empty &= tasks_return_from_io[i].empty();
-                ret_mutex[i].unlock();
-            }
-
-            // check if any IO is still working
-            bool any_io_busy = false;
-            for (int i = 0; i < NUM_IO; ++i){
-                any_io_busy &= io_running[i];
-            }
-
-            if (all_io_empty && !any_io_busy && all_ret_empty){
-                cpu_state[cpu_id].store(false); // tell IOs this cpu is idle
-            } else {
-                cpu_state[cpu_id].store(true);
-            }
-
-            if (shut_down.load()){
-                //safe_cerr("Shut down cpu #" + to_string(cpu_id) + "\n");
-                break;
-            }
-            continue;
-        }
-
-        if (task->bursts.empty()){
-            //cerr << "no time " << task->task_id << endl;
-            //continue;
-            throw runtime_error("no task duration time in processor");
-        }
-        auto job_type = task->bursts.front();
-        int device_id = job_type.first;
-        int duration = job_type.second;
-
-        bool run = false;
-        // CPU work
-        logger.write("CPU", cpu_id, task->task_id, "ENTER_CPU");
-        if (device_id < IO_ID_OFFSET){
-            //logger.write("CPU", cpu_id, task->task_id, "ENTER_CPU");
-
-            if (duration <= 0){
-                //continue;
-                throw runtime_error("duration time error in processor");
-            }
-            busy_sleep_microseconds(duration);
-            task->bursts.pop_back();
-
-            if (task->bursts.empty()){
-                logger.write("CPU", cpu_id, task->task_id, "FINISH_CPU", to_string(duration));
-                delete task;
-                continue;
-            }
-            run = true;
-            //logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU", to_string(duration));
-        }
-        // Finish CPU burst
-        if (run)
-            logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU", to_string(duration));
-        else
-            logger.write("CPU", cpu_id, task->task_id, "LEAVE_CPU");
-        // look at next job
-        job_type = task->bursts.front();
-        device_id = job_type.first;
-        duration = job_type.second;
-
-        if (device_id >= IO_ID_OFFSET){
-            int io_id = device_id - IO_ID_OFFSET;
-            io_mutex[io_id].lock();
-            io_queue[io_id].push({cpu_id, task});
-            io_mutex[io_id].unlock();
-        } else {
-            // more cpu time - return to scheduler
-            sched->return_task(cpu_id, task);
-            logger.write("CPU", cpu_id, task->task_id, "ENTER_SCHED");
-        }
-
-    }
-    cpu_state[cpu_id].store(false);
-    string message = "Total scheduling time for CPU #"+to_string(cpu_id) + ": "+to_string(total_elapsed.count())+", count = "+to_string(count)+"\n";
-    safe_cerr(message);
-    pthread_exit(nullptr);
-    return nullptr;
-}
-
-
-// argv[0] argv[1] argv[2]   argv[3]    argv[4]     argv[5]
-// ./main  NUM_CPU inputfile sched_algo workload_f1 workload_f2
+// argv[0] argv[1] argv[2]   argv[3]    argv[4]     argv[5]     options
+// ./main  NUM_CPU inputfile sched_algo workload_f1 workload_f2 [--coro[=workers]] [--io=num_io] [--io-depth=n] [--no-log]
 // -------------------- main --------------------
 int main(int argc, char *argv[]){
+    SimConfig config;
+    // options may appear anywhere, everything else is positional
+    vector<string> args;
+    for (int i = 0; i < argc; ++i){
+        string arg = argv[i];
+        if (arg == "--coro") config.coro_workers = 1;
+        else if (arg.rfind("--coro=", 0) == 0) config.coro_workers = stoi(arg.substr(7));
+        else if (arg.rfind("--io=", 0) == 0) config.num_io = stoi(arg.substr(5));
+        else if (arg.rfind("--io-depth=", 0) == 0) config.io_depth = stoi(arg.substr(11));
+        else if (arg == "--no-log") config.logging = false;
+        else args.push_back(arg);
+    }
+    argc = args.size();
+
     if (argc < 4){
-        cerr << "Usage: " << argv[0] << " <num_cpu (1-4)> <inputfile> <sched_algo (On/O1)\n";
+        cerr << "Usage: " << args[0] << " <num_cpu (1-" << MAX_NUM_CPU << ")> <inputfile> <sched_algo (On/O1/EDF)>"
+             << " [workload_f1] [workload_f2] [--coro[=workers]] [--io=num_io] [--io-depth=n] [--no-log]\n";
         return 1;
     }
 
-    int num_cpu = stoi(argv[1]);
-    if (num_cpu < 1 || num_cpu > 4){
-        cerr << "num_cpu must be 1..4\n";
+    config.num_cpu = stoi(args[1]);
+    if (config.num_cpu < 1 || config.num_cpu > MAX_NUM_CPU){
+        cerr << "num_cpu must be 1.." << MAX_NUM_CPU << "\n";
         return 1;
     }
-    NUM_CPU = num_cpu;
-
-    string filename = argv[2];
-    string sched_algo = argv[3];
-    workload_factor1 = (argc > 4 ? stoi(argv[4]) : 16);
-    workload_factor2 = (argc > 5 ? stoi(argv[5]) : 1);
-    cerr << "Total #tasks in ready queue(s): " << workload_factor1 << endl;
-    //cerr << "factor2 (#tasks be added after each cpu request): " << workload_factor2 << endl;
-    
-    // init scheduler
-    Scheduler *sched;
-    if (sched_algo == "On"){
-        sched = new Scheduler_On(filename);
+    if (config.num_io < 1 || config.num_io > MAX_NUM_IO){
+        cerr << "num_io must be 1.." << MAX_NUM_IO << "\n";
+        return 1;
     }
-    else if (sched_algo == "O1"){
-        sched = new Scheduler_O1(filename, NUM_CPU);
+    if (config.io_depth < 1){
+        cerr << "io depth must be positive\n";
+        return 1;
     }
-    else{
-        cerr << "choose scheduler algorithm (On/O1)";
+    if (config.coro_workers < 0){
+        cerr << "coroutine workers must be positive\n";
         return 1;
     }
 
+    config.trace = args[2];
+    config.algo = args[3];
+    config.workload.target = (argc > 4 ? stoi(args[4]) : 16);
+    config.workload.batch = (argc > 5 ? stoi(args[5]) : 1);
+    cerr << "Total #tasks in ready queue(s): " << config.workload.target << endl;
+    //cerr << "factor2 (#tasks be added after each cpu request): " << config.workload.batch << endl;
 
-    // set time
-    global_start_time = chrono::steady_clock::now();
-
-    // create IO threads
-    pthread_t io_threads[NUM_IO];
-    vector<int*> io_ids;
-    for (int i = 0; i < NUM_IO; ++i){
-        int device_id = IO_ID_OFFSET + i;
-        int *arg = new int(device_id);
-        io_ids.push_back(arg);
-        int ret = pthread_create(&io_threads[i], nullptr, IO_device, arg);
-        if (ret != 0){
-            cerr << "pthread_create error: IO\n";
-            return 1;
-        }
-    }
-
-    // create CPU threads
-    pthread_t cpu_threads[NUM_CPU];
-    vector<pair<int*, Scheduler*>*> cpu_params;
-    vector<int*> cpu_ids;
-    for (int i = 0; i < NUM_CPU; ++i){
-        int *id = new int(i);
-        cpu_ids.push_back(id);
-        auto *param = new pair<int*, Scheduler*>(id, sched);
-        cpu_params.push_back(param);
-        int ret = pthread_create(&cpu_threads[i], nullptr, processor, param);
-        if (ret != 0){
-            cerr << "pthread_create error: CPU\n";
-            return 1;
-        }
+    if (config.algo != "On" && config.algo != "O1" && config.algo != "EDF"){
+        cerr << "choose scheduler algorithm (On/O1/EDF)";
+        return 1;
     }
 
-    // join IO threads
-    for (int i = 0; i < NUM_IO; ++i){
-        pthread_join(io_threads[i], NULL);
-    }
+    Simulation sim(config);
+    SimResult result = sim.run();
 
-    // join CPU threads
-    for (int i = 0; i < NUM_CPU; ++i){
-        pthread_join(cpu_threads[i], NULL);
+    for (int i = 0; i < config.num_cpu; ++i){
+        cerr << "Total scheduling time for CPU #" << i << ": " << result.sched_ns[i] / 1000
+             << ", count = " << result.sched_calls[i] << "\n";
     }
-
-    // free small allocations
-    for (auto p : io_ids) delete p;
-    for (auto p : cpu_ids) delete p;
-    for (auto p : cpu_params) delete p;
-
-    delete sched;
+    cerr << result.metrics.to_string();
 
     //safe_cerr("Program exiting cleanly\n");
     return 0;
 }
 
-void busy_sleep_microseconds(int duration_us) {
-    auto start = std::chrono::steady_clock::now();
-    auto end = start + std::chrono::microseconds(duration_us);
-
-    while (std::chrono::steady_clock::now() < end) {
-        // busy wait
-    }
-}
-
 
 // version 10: including time stamp
 // set affinity to each threads
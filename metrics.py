@@ -6,6 +6,9 @@ LOG_FILE = "merged.log"
 pattern = re.compile(r"(\d+)\s+(\S+)\s+(\d+)\s+(\d+)\s+(\S+)(?:\s+(\d+))?")
 
 events = defaultdict(list)
+deadlines = {}      # task_id -> relative deadline (us), from DEADLINE events
+rejected = set()    # task_ids refused by EDF admission control
+cpu_bursts = defaultdict(list)  # task_id -> (timestamp, cpu) of every CPU burst
 
 with open(LOG_FILE, "r") as f:
     for line in f:
@@ -17,6 +20,15 @@ with open(LOG_FILE, "r") as f:
         device_id = int(m.group(3))
         task_id = int(m.group(4))
         event = m.group(5)
+        if event == "DEADLINE":
+            deadlines[task_id] = int(m.group(6))
+            continue
+        if event == "REJECT":
+            rejected.add(task_id)
+            continue
+        # a CPU burst ends with FINISH_CPU or a LEAVE_CPU carrying its duration
+        if device == "CPU" and (event == "FINISH_CPU" or (event == "LEAVE_CPU" and m.group(6))):
+            cpu_bursts[task_id].append((timestamp, device_id))
         events[task_id].append((timestamp, event))
 
 # Sort events by timestamp
@@ -53,8 +65,14 @@ for task_id, ev_list in events.items():
         if sched_before_cpu is not None:
             waiting_time += enter_cpu - sched_before_cpu
 
+    # deadline is relative to the first ENTER_SCHED, same as in the schedulers
+    missed = None
+    if task_id in deadlines:
+        missed = turnaround > deadlines[task_id]
+
     results.append({
         "task_id": task_id,
+        "missed": missed,
         "waiting_time": waiting_time,
         "turnaround_time": turnaround,
         "response_time": response
@@ -130,8 +148,8 @@ for cpu_id in sorted(cpu_lines.keys()):
     with open(f"cpu{cpu_id}.log", "r") as f:
         for line in f:
             parts = line.strip().split()
-            # Check if last part is a number
-            if parts[-1].isdigit():
+            # only CPU bursts carry their duration as the last field
+            if parts[4] in ("LEAVE_CPU", "FINISH_CPU") and parts[-1].isdigit():
                 total_exec_time += int(parts[-1])
 
     total_exec_times.append(total_exec_time)
@@ -179,4 +197,30 @@ for cpu_id in sorted(cpu_lines.keys()):
     else:
         #print(f"CPU {cpu_id}: {0:.2f}%")
         print(f"{0:.2f}")
-        
\ No newline at end of file
+        
+
+# Cache warmth: fraction of a task's CPU bursts (after its first) that ran on
+# the same cpu as its previous CPU burst
+resumed = warm = 0
+for task_id, bursts in cpu_bursts.items():
+    bursts.sort()
+    for (_, prev_cpu), (_, cpu) in zip(bursts, bursts[1:]):
+        resumed += 1
+        warm += prev_cpu == cpu
+if resumed:
+    print(f"Cache warmth: {warm}/{resumed} = {warm/resumed:.4f}")
+
+# Deadline miss ratio, only for traces with deadlines (d <deadline> in the task file).
+# Counted over admitted tasks, like Scheduler_EDF's own count; On/O1 reject
+# nothing, so there it covers every task with a deadline. Tasks EDF rejected
+# run best effort and are reported on their own line.
+deadline_results = [r for r in results if r["missed"] is not None]
+admitted_results = [r for r in deadline_results if r["task_id"] not in rejected]
+rejected_results = [r for r in deadline_results if r["task_id"] in rejected]
+if admitted_results:
+    num_missed = sum(1 for r in admitted_results if r["missed"])
+    print(f"Deadline miss ratio (admitted): {num_missed}/{len(admitted_results)}"
+          f" = {num_missed/len(admitted_results):.4f}")
+if rejected_results:
+    num_missed = sum(1 for r in rejected_results if r["missed"])
+    print(f"Rejected by admission: {len(rejected_results)}, of which missed: {num_missed}")
@@ -0,0 +1,118 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include "Stats.hpp"
+
+using namespace std;
+
+// read-only viewer for the stats segment written by ./main
+// ./schedtop [refresh_ms]
+
+// upper bound of a pick latency bucket in ns
+static uint64_t bucket_limit(int b){
+    return (uint64_t)1 << (b + 7);
+}
+
+static string format_ns(uint64_t ns){
+    ostringstream oss;
+    if (ns < 1000) oss << ns << "ns";
+    else if (ns < 1000000) oss << ns / 1000 << "us";
+    else oss << ns / 1000000 << "ms";
+    return oss.str();
+}
+
+// percentile estimated as the upper bound of the bucket containing it
+static string latency_percentile(const CpuCounters &c, double p){
+    uint64_t total = 0;
+    for (int b = 0; b < STATS_LATENCY_BUCKETS; ++b) total += c.pick_latency[b];
+    if (total == 0) return "-";
+    uint64_t rank = (uint64_t)(p * total);
+    uint64_t seen = 0;
+    for (int b = 0; b < STATS_LATENCY_BUCKETS; ++b){
+        seen += c.pick_latency[b];
+        if (seen > rank){
+            if (b == STATS_LATENCY_BUCKETS - 1) return ">" + format_ns(bucket_limit(b - 1));
+            return "<" + format_ns(bucket_limit(b));
+        }
+    }
+    return "-";
+}
+
+static double percent(uint64_t part, uint64_t whole){
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+int main(int argc, char *argv[]){
+    int refresh_ms = (argc > 1 ? stoi(argv[1]) : 500);
+    if (refresh_ms <= 0){
+        cerr << "refresh_ms must be positive\n";
+        return 1;
+    }
+
+    StatsSegment seg;
+    vector<CpuCounters> prev_cpu;
+    int32_t pid = -1;
+
+    while (true){
+        // a finished run keeps its segment until the next run replaces it, so remap
+        if (!seg.valid() || !seg.header()->running.load(memory_order_acquire)){
+            if (!seg.attach()){
+                cout << "\033[H\033[2Jwaiting for " << STATS_SHM_NAME << " ..." << endl;
+                this_thread::sleep_for(chrono::milliseconds(refresh_ms));
+                continue;
+            }
+        }
+        if (seg.header()->pid != pid){
+            pid = seg.header()->pid;
+            prev_cpu.assign(seg.header()->num_cpu, CpuCounters{});
+        }
+        const StatsHeader *h = seg.header();
+
+        ostringstream out;
+        out << "\033[H\033[2J";
+        out << "schedtop  pid " << h->pid << "  "
+            << (h->running.load(memory_order_acquire) ? "running" : "finished")
+            << "  refresh " << refresh_ms << "ms\n\n";
+
+        out << left << setw(5) << "CPU" << right
+            << setw(12) << "dispatched" << setw(10) << "rate/s"
+            << setw(8) << "rq_len" << setw(8) << "busy%"
+            << setw(10) << "pick p50" << setw(10) << "pick p99" << "\n";
+        for (uint32_t i = 0; i < h->num_cpu; ++i){
+            CpuCounters c;
+            out << left << setw(5) << i << right;
+            if (!seg.cpu(i)->load(c)){
+                out << setw(12) << "(busy)" << "\n";
+                continue;
+            }
+            double rate = (c.dispatched - prev_cpu[i].dispatched) * 1000.0 / refresh_ms;
+            prev_cpu[i] = c;
+            out << setw(12) << c.dispatched << setw(10) << fixed << setprecision(0) << rate
+                << setw(8) << c.runqueue_len
+                << setw(8) << setprecision(1) << percent(c.busy_us, c.busy_us + c.idle_us)
+                << setw(10) << latency_percentile(c, 0.50)
+                << setw(10) << latency_percentile(c, 0.99) << "\n";
+        }
+
+        out << "\n" << left << setw(5) << "IO" << right
+            << setw(12) << "served" << setw(8) << "depth" << setw(10) << "inflight" << setw(8) << "busy%" << "\n";
+        for (uint32_t i = 0; i < h->num_io; ++i){
+            IoCounters c;
+            out << left << setw(5) << i << right;
+            if (!seg.io(i)->load(c)){
+                out << setw(12) << "(busy)" << "\n";
+                continue;
+            }
+            out << setw(12) << c.served << setw(8) << c.queue_depth << setw(10) << c.in_flight
+                << setw(8) << fixed << setprecision(1) << percent(c.busy_us, c.busy_us + c.idle_us) << "\n";
+        }
+        cout << out.str() << flush;
+        this_thread::sleep_for(chrono::milliseconds(refresh_ms));
+    }
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+#include "Simulation.hpp"
+
+using namespace std;
+
+// parameter sweep: runs every combination of
+//   --algo=On,O1,EDF  --cpus=1,2,4  --wf1=8,16,32  --wf2=1  --traces=tasks/task512.txt
+// in-process and writes one row per run to --out (default sweep.csv).
+// each run is a fresh Simulation in coroutine mode (one worker thread, so one
+// core) with logs and the schedtop segment off. --jobs runs go at a time,
+// default one per core; more jobs than cores skews every timing in the csv.
+// --io=num_io and --io-depth=n apply to every run.
+
+static vector<string> split(const string &s){
+    vector<string> out;
+    string item;
+    istringstream iss(s);
+    while (getline(iss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+static vector<int> split_ints(const string &s){
+    vector<int> out;
+    for (const string &item : split(s)) out.push_back(stoi(item));
+    return out;
+}
+
+struct SweepRun {
+    SimConfig config;
+    SimResult result;
+    string error;   // empty if the run finished
+};
+
+static void write_header(ostream &out){
+    out << "trace,algo,num_cpu,workload_factor1,workload_factor2,num_io,io_depth,"
+        << "tasks,makespan_us,throughput_tasks_per_s,"
+        << "sched_calls,sched_total_us,sched_avg_ns,sched_overhead_pct,"
+        << "avg_waiting,p50_waiting,p95_waiting,p99_waiting,"
+        << "avg_turnaround,p50_turnaround,p95_turnaround,p99_turnaround,"
+        << "avg_response,p50_response,p95_response,p99_response,"
+        << "cache_warmth,deadline_admitted,deadline_rejected,deadline_missed\n";
+}
+
+static void write_row(ostream &out, const SweepRun &run){
+    const SimConfig &c = run.config;
+    const MetricsSummary &m = run.result.metrics;
+    long long calls = 0, ns = 0;
+    for (int i = 0; i < c.num_cpu; ++i){
+        calls += run.result.sched_calls[i];
+        ns += run.result.sched_ns[i];
+    }
+    // share of the cpus' time (over the makespan) spent picking tasks
+    double overhead = m.makespan > 0 ? ns / (m.makespan * 1000.0 * c.num_cpu) * 100 : 0;
+
+    out << c.trace << "," << c.algo << "," << c.num_cpu << ","
+        << c.workload.target << "," << c.workload.batch << ","
+        << c.num_io << "," << c.io_depth << ","
+        << m.num_tasks << "," << m.makespan << ","
+        << fixed << setprecision(2) << m.throughput << ","
+        << calls << "," << ns / 1000 << "," << (calls ? (double)ns / calls : 0) << ","
+        << setprecision(4) << overhead << "," << setprecision(2)
+        << m.avg_waiting << "," << m.waiting_pct[0] << "," << m.waiting_pct[1] << "," << m.waiting_pct[2] << ","
+        << m.avg_turnaround << "," << m.turnaround_pct[0] << "," << m.turnaround_pct[1] << "," << m.turnaround_pct[2] << ","
+        << m.avg_response << "," << m.response_pct[0] << "," << m.response_pct[1] << "," << m.response_pct[2] << ","
+        << setprecision(4) << m.cache_warmth << ","
+        << m.deadline_admitted << "," << m.deadline_rejected << "," << m.deadline_missed << "\n";
+}
+
+int main(int argc, char *argv[]){
+    vector<string> algos{"On", "O1", "EDF"};
+    vector<int> cpus{1, 2, 4};
+    vector<int> wf1s{8, 16, 32};
+    vector<int> wf2s{1};
+    vector<string> traces{"tasks/task512.txt"};
+    int num_io = 2, io_depth = 1;
+    int jobs = max(1u, thread::hardware_concurrency());
+    string out_file = "sweep.csv";
+
+    for (int i = 1; i < argc; ++i){
+        string arg = argv[i];
+        if (arg.rfind("--algo=", 0) == 0) algos = split(arg.substr(7));
+        else if (arg.rfind("--cpus=", 0) == 0) cpus = split_ints(arg.substr(7));
+        else if (arg.rfind("--wf1=", 0) == 0) wf1s = split_ints(arg.substr(6));
+        else if (arg.rfind("--wf2=", 0) == 0) wf2s = split_ints(arg.substr(6));
+        else if (arg.rfind("--traces=", 0) == 0) traces = split(arg.substr(9));
+        else if (arg.rfind("--io=", 0) == 0) num_io = stoi(arg.substr(5));
+        else if (arg.rfind("--io-depth=", 0) == 0) io_depth = stoi(arg.substr(11));
+        else if (arg.rfind("--jobs=", 0) == 0) jobs = stoi(arg.substr(7));
+        else if (arg.rfind("--out=", 0) == 0) out_file = arg.substr(6);
+        else {
+            cerr << "Usage: " << argv[0] << " [--algo=On,O1,EDF] [--cpus=1,2,4] [--wf1=8,16,32] [--wf2=1]"
+                 << " [--traces=tasks/task512.txt,...] [--io=num_io] [--io-depth=n] [--jobs=n] [--out=sweep.csv]\n";
+            return 1;
+        }
+    }
+
+    for (const string &algo : algos){
+        if (algo != "On" && algo != "O1" && algo != "EDF"){
+            cerr << "unknown scheduler algorithm " << algo << " (On/O1/EDF)\n";
+            return 1;
+        }
+    }
+    for (int n : cpus){
+        if (n < 1 || n > MAX_NUM_CPU){
+            cerr << "num_cpu must be 1.." << MAX_NUM_CPU << "\n";
+            return 1;
+        }
+    }
+    for (const string &trace : traces){
+        if (!ifstream(trace)){
+            cerr << "Cannot open file: " << trace << "\n";
+            return 1;
+        }
+    }
+    if (num_io < 1 || num_io > MAX_NUM_IO || io_depth < 1 || jobs < 1){
+        cerr << "num_io must be 1.." << MAX_NUM_IO << ", io depth and jobs must be positive\n";
+        return 1;
+    }
+
+    // grid order is the csv order, whatever order the runs finish in
+    vector<SweepRun> runs;
+    for (const string &trace : traces)
+        for (const string &algo : algos)
+            for (int num_cpu : cpus)
+                for (int wf1 : wf1s)
+                    for (int wf2 : wf2s){
+                        SweepRun run;
+                        run.config.trace = trace;
+                        run.config.algo = algo;
+                        run.config.num_cpu = num_cpu;
+                        run.config.num_io = num_io;
+                        run.config.io_depth = io_depth;
+                        run.config.workload = Workload{wf1, wf2};
+                        run.config.coro_workers = 1;
+                        run.config.logging = false;
+                        run.config.stats = false;
+                        runs.push_back(run);
+                    }
+
+    jobs = min<int>(jobs, runs.size());
+    cerr << runs.size() << " runs, " << jobs << " at a time\n";
+
+    atomic<size_t> next(0);
+    atomic<int> done(0);
+    mutex print_mutex;
+    auto worker = [&](){
+        for (size_t i = next++; i < runs.size(); i = next++){
+            SweepRun &run = runs[i];
+            try {
+                Simulation sim(run.config);
+                run.result = sim.run();
+            } catch (const exception &e){
+                run.error = e.what();
+            }
+            const SimConfig &c = run.config;
+            print_mutex.lock();
+            cerr << "[" << ++done << "/" << runs.size() << "] " << c.trace << " " << c.algo
+                 << " cpus=" << c.num_cpu << " wf=" << c.workload.target << "," << c.workload.batch;
+            if (run.error.empty())
+                cerr << " makespan=" << run.result.metrics.makespan << "us\n";
+            else
+                cerr << " failed: " << run.error << "\n";
+            print_mutex.unlock();
+        }
+    };
+    vector<thread> workers;
+    for (int i = 1; i < jobs; ++i) workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers) w.join();
+
+    ofstream out(out_file);
+    if (!out){
+        cerr << "Cannot open file: " << out_file << "\n";
+        return 1;
+    }
+    write_header(out);
+    bool ok = true;
+    for (const SweepRun &run : runs){
+        if (run.error.empty()) write_row(out, run);
+        else ok = false;
+    }
+    cerr << "wrote " << out_file << "\n";
+    return ok ? 0 : 1;
+}
@@ -12,12 +12,17 @@ def split_cpu_burst(cpu_id, duration, io_ids, max_cpu_time):
     return bursts
 
 
-def generate_task(task_id, max_cpu=2, max_cpu_burst=400, max_io_burst=150, max_cpu_time=300):
+def generate_task(task_id, max_cpu=2, max_cpu_burst=400, max_io_burst=150, max_cpu_time=300, deadline_slack=None,
+                  pin_every=None):
     """
     Generate a single simulated task with realistic Linux-style burst behavior.
     - First burst always CPU.
     - No consecutive bursts of same device type (CPU/I/O).
     - CPU bursts longer than max_cpu_time are split into smaller ones.
+    - If deadline_slack is set, realtime tasks get a relative deadline of
+      deadline_slack * (sum of all burst durations).
+    - If pin_every is set, every pin_every-th task gets a hard affinity to the
+      cpu of its first burst.
     """
     t = random.choices(
         ["cpu_bound", "interactive", "realtime", "background"],
@@ -104,6 +109,11 @@ def generate_task(task_id, max_cpu=2, max_cpu_burst=400, max_io_burst=150, max_c
         final_bursts += [current_dev, bursts[i + 1]]
 
     parts = [task_id, rt_priority, nice, policy] + final_bursts
+    # computed without drawing random numbers, so seeded traces stay identical
+    if deadline_slack is not None and t == "realtime":
+        parts += ["d", int(deadline_slack * sum(final_bursts[1::2]))]
+    if pin_every and task_id % pin_every == 0:
+        parts += ["a", final_bursts[0]]
     return " ".join(map(str, parts))
 
 
@@ -114,7 +124,9 @@ def generate_tasks(
     max_io_burst=150,
     max_cpu_time=300,
     seed=None,
-    output_file="tasks.txt"
+    output_file="tasks.txt",
+    deadline_slack=None,
+    pin_every=None
 ):
     """Generate n random tasks and write them to a text file."""
     if seed is not None:
@@ -122,7 +134,7 @@ def generate_tasks(
         print(f"[Seed set to {seed}]")
 
     tasks = [
-        generate_task(i, max_cpu, max_cpu_burst, max_io_burst, max_cpu_time)
+        generate_task(i, max_cpu, max_cpu_burst, max_io_burst, max_cpu_time, deadline_slack, pin_every)
         for i in range(n)
     ]
 
@@ -140,6 +152,8 @@ if __name__ == "__main__":
     max_io_burst = 150      # typical I/O burst upper bound
     max_cpu_time = 300      # split threshold for long CPU bursts
     seed_value = 777
+    deadline_slack = None   # e.g. 20 for tasks/task512_dl.txt
+    pin_every = None        # e.g. 4: every 4th task gets "a <cpu>" hard affinity
     output_filename = rf"tasks/task{num_tasks}.txt"
 
-    generate_tasks(num_tasks, max_cpu, max_cpu_burst, max_io_burst, max_cpu_time, seed_value, output_filename)
+    generate_tasks(num_tasks, max_cpu, max_cpu_burst, max_io_burst, max_cpu_time, seed_value, output_filename, deadline_slack, pin_every)